@@ -1,5 +1,5 @@
 /*
-  Setting time from the RV-8803 Real Time Clock
+  Setting time from the RV-3032 Real Time Clock
   By: Andy England
   SparkFun Electronics
   Date: 3/3/2020
@@ -17,9 +17,9 @@
     Open the serial monitor at 115200 baud
 */
 
-#include <SparkFun_RV8803.h>
+#include <SparkFun_RV3032.h>
 
-RV8803 rtc;
+RV3032 rtc;
 
 //The below variables control what the date and time will be set to
 int sec = 2;
@@ -0,0 +1,61 @@
+/*
+  Keep the RTC in UTC and print local time with daylight saving applied
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  This example shows how to convert the UTC time kept by the RTC to local time with a POSIX TZ rule,
+  and how to set the alarm in local time. The rule below is Central European Time, see
+  https://www.gnu.org/software/libc/manual/html_node/TZ-Variable.html for the format.
+
+  Hardware Connections:
+    Plug the RTC into the Qwiic port on your microcontroller or on your Qwiic shield/adapter.
+    If you are using an adapter cable, here is the wire color scheme: 
+    Black=GND, Red=3.3V, Blue=SDA, Yellow=SCL
+    Open the serial monitor at 115200 baud
+*/
+
+#include <SparkFun_RV3032.h>
+
+RV3032 rtc;
+RV3032TimeZone zone;
+
+void setup() {
+
+  Wire.begin();
+
+  Serial.begin(115200);
+  Serial.println("Local Time Example");
+
+  if (rtc.begin() == false) {
+    Serial.println("Something went wrong, check wiring");
+  }
+  else
+  {
+    Serial.println("RTC online!");
+  }
+
+  if (zone.setRule("CET-1CEST,M3.5.0,M10.5.0/3") == false) {
+    Serial.println("Time zone rule not understood");
+  }
+
+  rtc.updateTime();
+  rtc.setItemsToMatchForAlarm(true, true, false); //Match minutes and hours
+  rtc.setAlarmLocal(7, 30, zone); //07:30 local time, whatever the UTC offset is that day
+}
+
+void loop() {
+
+  if (rtc.updateTime() == false) //Updates the time variables from RTC
+  {
+    Serial.print("RTC failed to update");
+  }
+
+  uint32_t utc = rtc.getEpoch();
+  uint32_t local = rtc.getLocalEpoch(zone);
+  Serial.print("UTC: ");
+  Serial.print(utc);
+  Serial.print(" Local: ");
+  Serial.print(local);
+  Serial.println(zone.isDST(utc) ? " (DST)" : "");
+
+  delay(1000);
+}
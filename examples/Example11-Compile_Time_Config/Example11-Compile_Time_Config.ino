@@ -0,0 +1,52 @@
+/*
+  Configure the RTC in one transaction from a compile time profile
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  This example shows how to describe a fixed RTC setup with RV3032Config. The register values are worked out by the
+  compiler, invalid combinations (say a timer interrupt without a timer) stop the build, and begin(config) writes
+  everything in a single burst instead of calling one setter after another.
+
+  Hardware Connections:
+    Plug the RTC into the Qwiic port on your microcontroller or on your Qwiic shield/adapter.
+    If you are using an adapter cable, here is the wire color scheme: 
+    Black=GND, Red=3.3V, Blue=SDA, Yellow=SCL
+    Open the serial monitor at 115200 baud
+*/
+
+#include <SparkFun_RV3032.h>
+
+RV3032 rtc;
+
+//Countdown interrupt every 60 seconds, EVI capture on the rising edge with debounce, 1 Hz on CLKOUT
+RV3032_CONFIG(rtcConfig, RV3032Config()
+  .twelveHour(false)
+  .timer(COUNTDOWN_TIMER_FREQUENCY_1_HZ, 60)
+  .eviEdge(RISING_EDGE)
+  .eviDebounce(EVI_DEBOUNCE_256HZ)
+  .clockOut(CLKOUT_FREQUENCY_1_HZ)
+  .interrupts((1 << CONTROL2_TIE) | (1 << CONTROL2_EIE)));
+
+void setup() {
+
+  Wire.begin();
+
+  Serial.begin(115200);
+  Serial.println("Compile Time Config Example");
+
+  if (rtc.begin(rtcConfig) == false) {
+    Serial.println("Something went wrong, check wiring");
+  }
+  else
+  {
+    Serial.println("RTC online and configured!");
+  }
+}
+
+void loop() {
+  if (rtc.getInterruptFlag(STATUS_TF))
+  {
+    rtc.clearInterruptFlag(STATUS_TF);
+    rtc.updateTime();
+    Serial.println(rtc.stringTime());
+  }
+}
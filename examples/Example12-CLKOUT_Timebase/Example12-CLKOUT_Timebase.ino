@@ -0,0 +1,125 @@
+/*
+  Use CLKOUT as a timebase for the microcontroller
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  This example counts CLKOUT edges to keep time on the microcontroller without talking to the RTC. After one
+  reading to anchor the count, every timestamp comes from the edge counter alone, with the accuracy of the RTC
+  crystal. The same edges measure how far the microcontroller's own clock is off.
+
+  On an ATmega328P (Uno, Pro Mini...) CLKOUT runs at 32768 Hz into the Timer1 clock input, giving 30.5 us
+  resolution. Anywhere else CLKOUT runs at 1024 Hz into an interrupt pin and the edges are counted in software,
+  giving about 1 ms.
+
+  Hardware Connections:
+    Plug the RTC into the Qwiic port on your microcontroller or on your Qwiic shield/adapter.
+    If you are using an adapter cable, here is the wire color scheme: 
+    Black=GND, Red=3.3V, Blue=SDA, Yellow=SCL
+    Connect CLKOUT to pin 5 (T1) on an ATmega328P, or to pin 2 on other boards
+    Open the serial monitor at 115200 baud
+*/
+
+#include <SparkFun_RV3032.h>
+#include <RV3032_Timebase.h>
+
+RV3032 rtc;
+
+#if defined(__AVR_ATmega328P__)
+RV3032Timebase timebase(32768, 16); //Timer1 counts every edge, wraps every 2 seconds
+
+uint32_t readCounter()
+{
+  return TCNT1;
+}
+#else
+#define CLKOUT_PIN 2
+RV3032Timebase timebase(1024, 32);
+volatile uint32_t edgeCount = 0;
+
+void countEdge()
+{
+  edgeCount++;
+}
+
+uint32_t readCounter()
+{
+  noInterrupts();
+  uint32_t count = edgeCount;
+  interrupts();
+  return count;
+}
+#endif
+
+RV3032OscillatorCal cal(1000000); //micros() should tick at 1 MHz
+uint32_t lastReport = 0;
+uint16_t reports = 0;
+
+void setup() {
+
+  Wire.begin();
+
+  Serial.begin(115200);
+  Serial.println("CLKOUT Timebase Example");
+
+  if (rtc.begin() == false) {
+    Serial.println("Something went wrong, check wiring");
+  }
+  else
+  {
+    Serial.println("RTC online!");
+  }
+
+#if defined(__AVR_ATmega328P__)
+  rtc.enableClockOut(CLKOUT_FREQUENCY_32768_HZ);
+  TCCR1A = 0;
+  TCCR1B = (1 << CS12) | (1 << CS11) | (1 << CS10); //Clock Timer1 from rising edges on T1
+#else
+  rtc.enableClockOut(CLKOUT_FREQUENCY_1024_HZ);
+  pinMode(CLKOUT_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(CLKOUT_PIN), countEdge, RISING);
+#endif
+
+  //Anchor the count right after the RTC second changes, the only I2C traffic this example needs
+  rtc.updateTime();
+  uint8_t second = rtc.getSeconds();
+  while (rtc.getSeconds() == second)
+    rtc.updateTime();
+  uint32_t counter = readCounter();
+  timebase.setReference(counter, rtc.getTimestamp() - rtc.getHundredths());
+}
+
+void loop() {
+  //Call this at least once per counter wrap so no edges are lost
+  uint32_t counter = readCounter();
+  uint32_t now = micros();
+  uint64_t timestamp = timebase.getTimestampMicros(counter); //Microseconds since 2000-01-01
+  cal.addCapture(now, (uint32_t)timebase.getTicks());
+
+  if (millis() - lastReport >= 1000)
+  {
+    lastReport = millis();
+    uint32_t seconds = timestamp / 1000000;
+    Serial.print("Seconds since 2000: ");
+    Serial.print(seconds);
+    Serial.print(".");
+    uint32_t fraction = timestamp % 1000000;
+    for (uint32_t digit = 100000; digit > 1 && fraction < digit; digit /= 10)
+      Serial.print("0");
+    Serial.println(fraction);
+
+    //The longer the captures run the better the estimate, one micros() tick in ten seconds is 0.1 ppm
+    Serial.print("micros() runs ");
+    Serial.print(cal.getErrorPpm());
+    Serial.println(" ppm off the RTC");
+
+    //Running from the internal RC oscillator, the same measurement can trim it. On an ATmega328P each OSCCAL step is
+    //roughly 0.5%, so once a few seconds have been captured:
+    //  OSCCAL = cal.suggestTrim(OSCCAL, 5000, 0, 255);
+    //  cal.reset();
+
+    if (++reports == 3600)
+    {
+      reports = 0;
+      cal.reset(); //Start over every hour, before the micros() span wraps
+    }
+  }
+}
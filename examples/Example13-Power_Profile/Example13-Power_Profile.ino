@@ -0,0 +1,76 @@
+/*
+  Apply a low power profile and measure what each wake up costs
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  This example sets the RTC up for a coin cell on VBACKUP (backup switchover on, trickle charger off, EEPROM
+  refresh off, CLKOUT off, wake only on INT) and attaches an energy meter. Every RTC transaction adds to the
+  meter, so each wake cycle reports how long the bus was busy and the charge it cost in uAs, which is what you
+  need to size the battery.
+
+  The charge model assumes 5 mA for the running MCU and 1.5 mA through the I2C pull-ups at 100 kHz. Change the
+  RV3032EnergyMeter arguments to match your board.
+
+  Hardware Connections:
+    Plug the RTC into the Qwiic port on your microcontroller or on your Qwiic shield/adapter.
+    If you are using an adapter cable, here is the wire color scheme: 
+    Black=GND, Red=3.3V, Blue=SDA, Yellow=SCL
+    Open the serial monitor at 115200 baud
+*/
+
+#include <SparkFun_RV3032.h>
+
+RV3032 rtc;
+RV3032EnergyMeter meter(100000, 5000, 1500); //I2C clock in Hz, MCU current in uA, pull-up current in uA
+
+#define WAKE_INTERVAL_S 60
+#define BATTERY_MAH 220 //CR2032
+
+void setup() {
+
+  Wire.begin();
+
+  Serial.begin(115200);
+  Serial.println("Power Profile Example");
+
+  if (rtc.begin() == false) {
+    Serial.println("Something went wrong, check wiring");
+  }
+  else
+  {
+    Serial.println("RTC online!");
+  }
+
+  if (rtc.setPowerProfile(RV3032_POWER_INTERRUPT_ONLY) == false)
+    Serial.println("Could not apply the power profile");
+
+  rtc.setEnergyMeter(&meter);
+}
+
+void loop() {
+  //One wake cycle: everything the application does with the RTC between sleeps
+  meter.beginCycle(micros());
+  rtc.updateTime();
+  rtc.getInterruptFlag(FLAG_ALARM);
+  meter.endCycle(micros());
+
+  Serial.print(rtc.stringTime());
+  Serial.print(" transactions: ");
+  Serial.print(meter.getCycleTransactions());
+  Serial.print(" bus: ");
+  Serial.print(meter.getCycleBusMicros());
+  Serial.print(" us, charge: ");
+  Serial.print(meter.getCycleChargeNanoAs() / 1000.0, 3);
+  Serial.println(" uAs");
+
+  //Average current of the wake ups alone, add the sleep current of the MCU and RTC for the full budget
+  float averageMicroamps = meter.getAverageChargeNanoAs() / 1000.0 / WAKE_INTERVAL_S;
+  Serial.print("Waking every ");
+  Serial.print(WAKE_INTERVAL_S);
+  Serial.print(" s costs ");
+  Serial.print(averageMicroamps, 4);
+  Serial.print(" uA on average, ");
+  Serial.print(BATTERY_MAH * 1000.0 / averageMicroamps / 24 / 365, 0);
+  Serial.println(" years of a CR2032 on its own");
+
+  delay(WAKE_INTERVAL_S * 1000UL); //Sleep here in a real design and wake on INT
+}
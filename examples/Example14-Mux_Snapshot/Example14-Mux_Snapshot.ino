@@ -0,0 +1,70 @@
+/*
+  Compare several RTCs behind an I2C multiplexer
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  Every RV-3032 answers at the same address, so boards with several of them put each one on its own channel of
+  a TCA9548A multiplexer. RV3032Mux switches channels only when needed, reads every clock in one pass and
+  reports how far apart they are, the time most of them agree on and which ones look unhealthy.
+
+  Hardware Connections:
+    Connect a TCA9548A (address 0x70) to the Qwiic port, and an RTC to each of its channels 0 to 3.
+    Open the serial monitor at 115200 baud
+*/
+
+#include <RV3032_Mux.h>
+
+RV3032Mux mux;
+RV3032MuxSnapshot snap;
+
+void setup() {
+
+  Wire.begin();
+
+  Serial.begin(115200);
+  Serial.println("Mux Snapshot Example");
+
+  if (mux.begin() == false) {
+    Serial.println("Multiplexer not found, check wiring");
+  }
+
+  for (uint8_t channel = 0; channel < 4; channel++)
+    mux.addDevice(channel);
+}
+
+void loop() {
+  if (mux.snapshot(snap) == false)
+  {
+    Serial.println("No clock answered");
+  }
+  else
+  {
+    Serial.print("Skew: ");
+    Serial.print(snap.skewMs);
+    Serial.print(" ms, voted time: ");
+    Serial.print((uint32_t)(snap.votedHundredths / 100));
+    Serial.print(snap.majority ? " s since 2000 (majority)" : " s since 2000 (no majority)");
+    Serial.print(", mux writes: ");
+    Serial.println(snap.channelWrites);
+
+    for (uint8_t i = 0; i < mux.getDeviceCount(); i++)
+    {
+      Serial.print("  RTC ");
+      Serial.print(i);
+      Serial.print(mux.isHealthy(i) ? " healthy" : " UNHEALTHY");
+      Serial.print(", failed reads: ");
+      Serial.print(mux.getHealth(i).failures);
+      Serial.print(", outvoted: ");
+      Serial.println(mux.getHealth(i).outvoted);
+    }
+  }
+
+  //Talk to one of the clocks directly
+  if (mux.select(0))
+  {
+    mux.getDevice(0).updateTime();
+    Serial.print("RTC 0: ");
+    Serial.println(mux.getDevice(0).stringTime());
+  }
+
+  delay(5000);
+}
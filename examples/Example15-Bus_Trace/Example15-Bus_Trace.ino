@@ -0,0 +1,87 @@
+/*
+  Record every I2C transaction of the library and dump it for the host replayer
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  This example attaches an RV3032TraceRecorder to the RTC. Every register read and write is logged with
+  its address, direction, data and time into a 256 byte buffer, and whenever the buffer fills it is printed
+  as hex, so nothing is lost. Each API call is tagged with mark() first, so the replayer can report what
+  every call costs.
+
+  Copy everything between the TRACE lines into a file on your computer and run
+    rv3032_replay trace.txt                   transactions, bytes and time per call
+    rv3032_replay --drive trace.txt new.rvt   the same calls through a newer library, against what this RTC answered
+    rv3032_replay trace.txt new.rvt           compare two traces
+  extras/host/rv3032_replay.cpp says how to build it.
+
+  Hardware Connections:
+    Plug the RTC into the Qwiic port on your microcontroller or on your Qwiic shield/adapter.
+    If you are using an adapter cable, here is the wire color scheme: 
+    Black=GND, Red=3.3V, Blue=SDA, Yellow=SCL
+    Open the serial monitor at 115200 baud
+*/
+
+#include <SparkFun_RV3032.h>
+
+RV3032 rtc;
+
+#define CALLS 30 //Calls to record before the trace is closed
+
+void printTrace(const uint8_t * data, uint16_t len)
+{
+  for (uint16_t i = 0; i < len; i++)
+  {
+    if (data[i] < 0x10)
+      Serial.print("0");
+    Serial.print(data[i], HEX);
+    if (i % 32 == 31)
+      Serial.println();
+  }
+  Serial.println();
+}
+
+uint8_t traceBuffer[256];
+RV3032TraceRecorder recorder(traceBuffer, sizeof(traceBuffer), printTrace);
+RV3032EventBuffer events;
+uint8_t calls = 0;
+
+void setup() {
+
+  Wire.begin();
+
+  Serial.begin(115200);
+  Serial.println("Bus Trace Example");
+  Serial.println("TRACE");
+
+  rtc.setTraceRecorder(&recorder);
+  recorder.mark(TRACE_TAG_BEGIN, micros());
+  if (rtc.begin() == false) {
+    Serial.println("Something went wrong, check wiring");
+  }
+
+  recorder.mark(TRACE_TAG_CALIBRATION, micros());
+  rtc.getCalibrationOffsetSteps();
+}
+
+void loop() {
+  if (calls == CALLS)
+    return;
+
+  recorder.mark(TRACE_TAG_UPDATE_TIME, micros());
+  rtc.updateTime();
+  recorder.mark(TRACE_TAG_DRAIN_EVI, micros());
+  rtc.drainEVIEvents(events);
+  events.clear();
+  calls += 2;
+
+  if (calls == CALLS)
+  {
+    recorder.flush(); //What is still in the buffer
+    rtc.setTraceRecorder(NULL);
+    Serial.println("TRACE");
+    Serial.print(recorder.getTransactions());
+    Serial.print(" transactions, ");
+    Serial.print(recorder.getDropped());
+    Serial.println(" dropped");
+  }
+  delay(1000);
+}
@@ -0,0 +1,82 @@
+/*
+  Measure how long your firmware takes to react to an external event
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  The same signal goes to the EVI pin of the RTC and to an interrupt pin of the microcontroller. The RTC
+  stamps the edge in hardware, the interrupt handler notes micros(), and the profiler maps the RTC stamp
+  to micros() (it syncs the two clocks every 10 seconds) to get the latency of every event. After every
+  100 events it prints a histogram.
+
+  The RTC stamps to the hundredth of a second, so a single latency is only good to +-5 ms. Events fall at
+  random points inside the hundredth, so this averages out: after a few hundred events the mean is good to
+  a fraction of a millisecond, and the histogram shows your latencies smeared over 10 ms.
+  EVI debouncing delays the stamp, keep it off while profiling.
+
+  Hardware Connections:
+    Plug the RTC into the Qwiic port on your microcontroller or on your Qwiic shield/adapter.
+    If you are using an adapter cable, here is the wire color scheme: 
+    Black=GND, Red=3.3V, Blue=SDA, Yellow=SCL
+    Connect your event source to the EVI pin and to pin 2 (no faster than one event per loop())
+    Open the serial monitor at 115200 baud
+*/
+
+#include <SparkFun_RV3032.h>
+#include <RV3032_Latency.h>
+
+RV3032 rtc;
+RV3032LatencyHistogram histogram; //1 ms bins from -6 ms
+RV3032LatencyProfiler profiler(rtc, histogram);
+
+#define EVENT_PIN 2
+#define REPORT_EVERY 100
+
+void onEvent()
+{
+  profiler.handlerRan(); //First, before the work the handler does
+  //... the handler you want to measure
+}
+
+void setup() {
+
+  Wire.begin();
+
+  Serial.begin(115200);
+  Serial.println("Interrupt Latency Example");
+
+  if (rtc.begin() == false) {
+    Serial.println("Something went wrong, check wiring");
+  }
+
+  rtc.setEVIDebounceTime(EVI_DEBOUNCE_NONE);
+  rtc.setEVIEdgeDetection(RISING_EDGE);
+  if (profiler.begin() == false)
+    Serial.println("Could not sync to the RTC");
+
+  pinMode(EVENT_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(EVENT_PIN), onEvent, RISING);
+}
+
+void loop() {
+  if (profiler.update() == false || histogram.getCount() % REPORT_EVERY != 0)
+    return;
+
+  for (uint8_t bin = 0; bin < histogram.getBins(); bin++)
+  {
+    if (histogram.getBin(bin) == 0)
+      continue;
+    Serial.print(histogram.getBinStart(bin));
+    Serial.print(" us\t");
+    Serial.println(histogram.getBin(bin));
+  }
+  Serial.print("Events: ");
+  Serial.print(profiler.getEvents());
+  Serial.print(" missed: ");
+  Serial.print(profiler.getMissed());
+  Serial.print(" mean: ");
+  Serial.print(histogram.getMean());
+  Serial.print(" us p90: ");
+  Serial.print(histogram.getPercentile(90));
+  Serial.print(" us MCU clock: ");
+  Serial.print(profiler.getClockMap().getDriftPpm());
+  Serial.println(" ppm");
+}
@@ -0,0 +1,77 @@
+/*
+  Let the getters read the RTC only when the time they hold is too old
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  Normally getSeconds(), stringTime() and friends return what the last updateTime() read, so sketches call
+  updateTime() before every getter just in case and pay a full I2C burst each time. With setTimeMaxAge() the
+  getters do it themselves, and only when the copy is older than the limit. Here the limit is 1 second and the
+  periodic time update interrupt marks the copy as old the moment the RTC second changes, so the time is never
+  behind while the bus sees one burst per second, however often loop() asks.
+
+  Getters that belong together go in one RV3032TimeHold: they all see the same reading, so hh:mm:ss can't be
+  torn across a second boundary.
+
+  Hardware Connections:
+    Plug the RTC into the Qwiic port on your microcontroller or on your Qwiic shield/adapter.
+    If you are using an adapter cable, here is the wire color scheme: 
+    Black=GND, Red=3.3V, Blue=SDA, Yellow=SCL
+    Connect INT to pin 2
+    Open the serial monitor at 115200 baud
+*/
+
+#include <SparkFun_RV3032.h>
+
+RV3032 rtc;
+
+#define INT_PIN 2
+
+uint32_t getterCalls = 0;
+uint8_t lastSecond = 0xFF;
+
+void onUpdate()
+{
+  rtc.notifyTimeUpdate(); //No I2C in here, the next getter reads the new time
+}
+
+void setup() {
+
+  Wire.begin();
+
+  Serial.begin(115200);
+  Serial.println("Lazy Refresh Example");
+
+  if (rtc.begin() == false) {
+    Serial.println("Something went wrong, check wiring");
+  }
+
+  rtc.setTimeMaxAge(1000); //Even if an interrupt is missed the time is at most a second old
+
+  rtc.disableAllInterrupts();
+  rtc.clearAllInterruptFlags();
+  rtc.setPeriodicTimeUpdateFrequency(TIME_UPDATE_1_SECOND);
+  rtc.enableHardwareInterrupt(UPDATE_INTERRUPT);
+
+  pinMode(INT_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(INT_PIN), onUpdate, FALLING);
+}
+
+void loop() {
+  uint32_t secondOfDay;
+  {
+    RV3032TimeHold hold(rtc); //One reading for all three
+    secondOfDay = rtc.getHours() * 3600UL + rtc.getMinutes() * 60UL + rtc.getSeconds();
+  }
+  getterCalls += 3;
+
+  if (secondOfDay % 60 != lastSecond)
+  {
+    lastSecond = secondOfDay % 60;
+    Serial.print(rtc.stringTime()); //Same reading, no burst
+    Serial.print(" second of the day: ");
+    Serial.print(secondOfDay);
+    Serial.print(", getter calls in the last second: ");
+    Serial.println(getterCalls);
+    getterCalls = 0;
+    rtc.clearInterruptFlag(FLAG_UPDATE);
+  }
+}
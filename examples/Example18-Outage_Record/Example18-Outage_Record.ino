@@ -0,0 +1,71 @@
+/*
+  Find out at boot how long the main supply was gone
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  The RV-3032 keeps counting on its backup supply but has no timestamp for the switchover itself. Its EVI
+  input works on the backup supply though, so wire the main supply to EVI as well: when it drops, the RTC
+  stamps the time of the falling edge and sets BSF once it switches to the backup. At the next boot
+  getOutageRecord() reads the time, the flags and the stamp in two bursts and works out how long the
+  outage lasted, and whether the time can be trusted at all (VLF and PORF clear).
+
+  A short outage means the state the device keeps is still good, a long one that it has to be fetched again.
+
+  Hardware Connections:
+    Plug the RTC into the Qwiic port on your microcontroller or on your Qwiic shield/adapter.
+    If you are using an adapter cable, here is the wire color scheme: 
+    Black=GND, Red=3.3V, Blue=SDA, Yellow=SCL
+    Fit a backup supply (supercap or coin cell) to VBACKUP
+    Connect the main supply to EVI, through a divider if it is above the RTC supply
+    Open the serial monitor at 115200 baud
+*/
+
+#include <SparkFun_RV3032.h>
+
+RV3032 rtc;
+
+#define SHORT_OUTAGE_SECONDS 600 //Up to this long the state kept is still good
+
+void setup() {
+
+  Wire.begin();
+
+  Serial.begin(115200);
+  Serial.println("Outage Record Example");
+
+  if (rtc.begin() == false) {
+    Serial.println("Something went wrong, check wiring");
+  }
+
+  RV3032OutageRecord record;
+  if (rtc.getOutageRecord(record) == false) {
+    Serial.println("Could not read the outage record");
+  }
+  else if (record.timeTrusted == false) {
+    Serial.println("The RTC lost its time, set it and resync everything");
+  }
+  else if (record.outage == false) {
+    Serial.println("No outage since the last boot (reset or brownout of the MCU only)");
+  }
+  else if (record.startKnown == false) {
+    Serial.println("The RTC ran from its backup but EVI didn't stamp the drop, resync everything");
+  }
+  else {
+    Serial.print("Supply dropped at epoch ");
+    Serial.print(record.start);
+    Serial.print(" and was gone for ");
+    Serial.print(record.duration);
+    Serial.println(" seconds");
+    if (record.duration <= SHORT_OUTAGE_SECONDS)
+      Serial.println("Short outage, skipping the full resync");
+    else
+      Serial.println("Long outage, resync everything");
+  }
+  Serial.println(rtc.stringTime()); //Read along with the record, no extra I2C
+
+  //Once per boot: switch over at 2.0 V and get the next drop stamped. This also clears the record just read
+  rtc.setPowerProfile(RV3032PowerProfile().backupSwitchover(BACKUP_SWITCHOVER_LEVEL));
+  rtc.enableOutageCapture();
+}
+
+void loop() {
+}
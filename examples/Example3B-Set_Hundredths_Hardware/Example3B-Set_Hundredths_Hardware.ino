@@ -17,9 +17,9 @@
     Open the serial monitor at 115200 baud
 */
 
-#include <SparkFun_RV8803.h>
+#include <SparkFun_RV3032.h>
 
-RV8803 rtc;
+RV3032 rtc;
 
 #define EVI_TRIGGER_PIN 13 //If you have a 3.3V microcontroller or a logic level converter, you can connect this pin to trigger the reset of the hundredths register
 
@@ -1,5 +1,5 @@
 /*
-  Getting the alarm to fire an interrupt on the RV-8803 Real Time Clock
+  Getting the alarm to fire an interrupt on the RV-3032 Real Time Clock
   By: Andy England
   SparkFun Electronics
   Date: 3/3/2020
@@ -18,21 +18,19 @@
     Open the serial monitor at 115200 baud
 */
 
-#include <SparkFun_RV8803.h>
+#include <SparkFun_RV3032.h>
 
-RV8803 rtc;
+RV3032 rtc;
 
 //Make sure to change these values to the decimal values that you want to match
 uint8_t minuteAlarmValue = 55; //0-60, change this to a minute or two from now to see the alarm get generated
 uint8_t hourAlarmValue = 0; //0-24
-uint8_t weekdayAlarmValue = SUNDAY | SATURDAY; //Or together days of the week to enable the alarm on those days.
-uint8_t dateAlarmValue = 0; //1-31
+uint8_t dateAlarmValue = 1; //1-31
 
-//Define which alarm registers we want to match, make sure you only enable weekday or date alarm, enabling both will default to a date alarm
+//Define which alarm registers we want to match. The RV-3032 has no weekday alarm, use the date alarm instead
 //In its current state, an alarm will be generated once an hour, when the MINUTES registers on the time and alarm match. Setting MINUTE_ALARM_ENABLE to false would trigger an alarm every minute
 #define MINUTE_ALARM_ENABLE true
 #define HOUR_ALARM_ENABLE false
-#define WEEKDAY_ALARM_ENABLE false
 #define DATE_ALARM_ENABLE false
 
 void setup() {
@@ -48,11 +46,10 @@ void setup() {
 
   rtc.disableAllInterrupts();
   rtc.clearAllInterruptFlags();//Clear all flags in case any interrupts have occurred.
-  rtc.setItemsToMatchForAlarm(MINUTE_ALARM_ENABLE, HOUR_ALARM_ENABLE, WEEKDAY_ALARM_ENABLE, DATE_ALARM_ENABLE); //The alarm interrupt compares the alarm interrupt registers with the current time registers. We must choose which registers we want to compare by setting bits to true or false
+  rtc.setItemsToMatchForAlarm(MINUTE_ALARM_ENABLE, HOUR_ALARM_ENABLE, DATE_ALARM_ENABLE); //The alarm interrupt compares the alarm interrupt registers with the current time registers. We must choose which registers we want to compare by setting bits to true or false
   rtc.setAlarmMinutes(minuteAlarmValue);
   rtc.setAlarmHours(hourAlarmValue);
-  rtc.setAlarmWeekday(weekdayAlarmValue);
-  //rtc.setAlarmDate(dateAlarmValue); //Uncomment this line if you are using the date alarm instead of the weekday alarm.
+  rtc.setAlarmDate(dateAlarmValue);
   rtc.enableHardwareInterrupt(ALARM_INTERRUPT); 
 }
 
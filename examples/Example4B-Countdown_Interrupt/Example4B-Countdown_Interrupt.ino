@@ -17,9 +17,9 @@
     Open the serial monitor at 115200 baud
 */
 
-#include <SparkFun_RV8803.h>
+#include <SparkFun_RV3032.h>
 
-RV8803 rtc;
+RV3032 rtc;
 
 long lastInterruptTime = 0;
 
@@ -1,5 +1,5 @@
 /*
-  Getting the alarm to fire a periodic interrupt on the RV-8803 Real Time Clock
+  Getting the alarm to fire a periodic interrupt on the RV-3032 Real Time Clock
   By: Andy England
   SparkFun Electronics
   Date: 3/2/2020
@@ -17,9 +17,9 @@
     Open the serial monitor at 115200 baud
 */
 
-#include <SparkFun_RV8803.h>
+#include <SparkFun_RV3032.h>
 
-RV8803 rtc;
+RV3032 rtc;
 
 long lastInterruptTime;
 
@@ -1,5 +1,5 @@
 /*
-  Fine Tune the Crystal Oscillator in the RV-8803
+  Fine Tune the Crystal Oscillator in the RV-3032
   By: Andy England
   SparkFun Electronics
   Date: 3/2/2020
@@ -17,9 +17,9 @@
     Open the serial monitor at 115200 baud
 */
 
-#include <SparkFun_RV8803.h>
+#include <SparkFun_RV3032.h>
 
-RV8803 rtc;
+RV3032 rtc;
 
 void setup() {
 
@@ -36,8 +36,8 @@ void setup() {
     Serial.println("RTC online!");
   }
   rtc.setCalibrationOffset(0); //Zero out any calibration settings we may have
-  rtc.setClockOutTimerFrequency(CLOCK_OUT_FREQUENCY_1_HZ); //Set our clockout to a 1 Hz square wave,
-  //We now must measure the frequency on the Clock Out carefully to calibrate our crystal. To start generating a signal on Clock Out, tie CLKOE High.
+  rtc.setClockOutTimerFrequency(CLKOUT_FREQUENCY_1_HZ); //Set our clockout to a 1 Hz square wave,
+  //We now must measure the frequency on the Clock Out carefully to calibrate our crystal. The RV-3032 drives CLKOUT by default (NCLKE cleared in the PMU register).
   //Change measuredFrequency accordingly, note that you can only correct +/-7.6288 ppm
   float measuredFrequency = 1.0000012; //Measured frequency in Hz (CHANGE THIS TO YOUR MEASURED VALUE)
   float newPPM = (measuredFrequency - 1) * 1000000; //Calculate PPM difference between measuredFrequency and our desired 1 Hz wave
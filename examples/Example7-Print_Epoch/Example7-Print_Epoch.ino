@@ -1,5 +1,5 @@
 /*
-  Prints the UNIX Epoch time from the RV-8803 Real Time Clock
+  Prints the UNIX Epoch time from the RV-3032 Real Time Clock
   By: Andy England
   SparkFun Electronics
   Updated by: Adam Garbo
@@ -15,9 +15,9 @@
     Open the serial monitor at 115200 baud
 */
 
-#include <SparkFun_RV8803.h>
+#include <SparkFun_RV3032.h>
 
-RV8803 rtc;
+RV3032 rtc;
 
 void setup() {
 
@@ -0,0 +1,60 @@
+/*
+  Drain bursts of EVI events into a ring buffer without losing count
+  License: This code is public domain but you buy me a beer if you use this and we meet someday (Beerware license).
+
+  This example shows how to capture a fast stream of events on the EVI pin. The RTC counts every event and keeps the
+  timestamp of either the first or the last one. drainEVIEvents() reads the counter and the full capture block in one
+  burst, resets them, and pushes a decoded event into a ring buffer, so you know exactly how many events happened
+  between two drains even when only one timestamp survives.
+
+  Hardware Connections:
+    Plug the RTC into the Qwiic port on your microcontroller or on your Qwiic shield/adapter.
+    If you are using an adapter cable, here is the wire color scheme: 
+    Black=GND, Red=3.3V, Blue=SDA, Yellow=SCL
+    Connect your trigger source to the EVI pin
+    Open the serial monitor at 115200 baud
+*/
+
+#include <SparkFun_RV3032.h>
+
+RV3032 rtc;
+RV3032EventBuffer events;
+
+void setup() {
+
+  Wire.begin();
+
+  Serial.begin(115200);
+  Serial.println("EVI Event Drain Example");
+
+  if (rtc.begin() == false) {
+    Serial.println("Something went wrong, check wiring");
+  }
+  else
+  {
+    Serial.println("RTC online!");
+  }
+
+  rtc.setEVIDebounceTime(EVI_DEBOUNCE_256HZ);
+  rtc.setTSOverwrite(EVI_CAPTURE_FIRST_EVENT); //Or EVI_CAPTURE_LAST_EVENT to keep the most recent timestamp
+  rtc.setEVIEventCapture(EVI_CAPTURE_ENABLE); //Starts from a clean counter
+}
+
+void loop() {
+  rtc.drainEVIEvents(events);
+
+  RV3032Event event;
+  while (events.pop(event))
+  {
+    char line[48];
+    sprintf(line, "%u event(s), captured at 20%02u-%02u-%02u %02u:%02u:%02u.%02u", event.count, event.year, event.month, event.date, event.hours, event.minutes, event.seconds, event.hundredths);
+    Serial.println(line);
+  }
+
+  Serial.print("Total events: ");
+  Serial.print(rtc.getEVIEventTotal());
+  Serial.print(" Dropped captures: ");
+  Serial.println(events.getDropped());
+
+  delay(100);
+}
@@ -0,0 +1,261 @@
+/******************************************************************************
+rv3032_batch.cpp
+RV3032 Arduino Library
+
+Host side bulk conversion of RV-3032 time images. See rv3032_batch.h.
+
+The vector kernels load 4 records per 128 bits (2 per 128 bit lane for AVX2), regroup them
+so that one 32 bit lane holds the low half (hundredths, seconds, minutes, hours) or the high
+half (weekday, date, month, year) of one record, decode BCD bytewise and then do the calendar
+math in 32 bit lanes. Months outside 1-12 and date 0 are clamped the same way
+rv3032DaysSince2000() does it, so raw register data gives the same result on every path. Epoch seconds stay below 2^32 until 2106, so only the final
+multiplication by 1000 needs 64 bits.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "rv3032_batch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RV3032_BATCH_X86
+#include <immintrin.h>
+#endif
+
+//Register masks applied before BCD decoding, same as rv3032TimeToHundredths()
+#define LOW_HALF_MASK  0x3F7F7FFF // hours, minutes, seconds, hundredths
+#define HIGH_HALF_MASK 0xFF1F3F07 // year, month, date, weekday
+
+//Days before each month minus 30 * (month - 1), plus one so the table fits in unsigned bytes
+#define MONTH_CORRECTION 1, 2, 0, 1, 1, 2, 2, 3, 4, 4, 5, 5, 0, 0, 0, 0
+
+uint64_t rv3032ImageToEpochMs(const uint8_t * image)
+{
+	return RV3032_EPOCH_2000 * 1000ULL + rv3032TimeToHundredths(image) * 10;
+}
+
+static void imagesToEpochMsScalar(const uint8_t * images, uint64_t * epochMs, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		epochMs[i] = rv3032ImageToEpochMs(images + i * RV3032_IMAGE_LENGTH);
+	}
+}
+
+#ifdef RV3032_BATCH_X86
+
+__attribute__((target("sse4.1")))
+static void imagesToEpochMsSSE41(const uint8_t * images, uint64_t * epochMs, size_t count)
+{
+	const __m128i lowMask = _mm_set1_epi32(LOW_HALF_MASK);
+	const __m128i highMask = _mm_set1_epi32(HIGH_HALF_MASK);
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	const __m128i correction = _mm_setr_epi8(MONTH_CORRECTION);
+	const __m128i indexFill = _mm_set1_epi32(0x80808000); //Zeroes the upper 3 bytes of each lane in the lookup
+	const __m128i one = _mm_set1_epi32(1);
+	const __m128i two = _mm_set1_epi32(2);
+	const __m128i three = _mm_set1_epi32(3);
+	const __m128i thirteen = _mm_set1_epi32(13);
+	const __m128i epoch = _mm_set1_epi32(RV3032_EPOCH_2000);
+	const __m128i thousand = _mm_set1_epi32(1000);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const uint8_t * src = images + i * RV3032_IMAGE_LENGTH;
+		__m128i a = _mm_loadu_si128((const __m128i *)src); //r0lo r0hi r1lo r1hi
+		__m128i b = _mm_loadu_si128((const __m128i *)(src + 16)); //r2lo r2hi r3lo r3hi
+		a = _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 1, 2, 0)); //r0lo r1lo r0hi r1hi
+		b = _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 1, 2, 0));
+		__m128i low = _mm_and_si128(_mm_unpacklo_epi64(a, b), lowMask);
+		__m128i high = _mm_and_si128(_mm_unpackhi_epi64(a, b), highMask);
+
+		//BCD to decimal in every byte: ones + tens * 8 + tens * 2
+		__m128i tens = _mm_and_si128(_mm_srli_epi16(low, 4), nibble);
+		low = _mm_add_epi8(_mm_and_si128(low, nibble), _mm_add_epi8(_mm_slli_epi16(tens, 3), _mm_slli_epi16(tens, 1)));
+		tens = _mm_and_si128(_mm_srli_epi16(high, 4), nibble);
+		high = _mm_add_epi8(_mm_and_si128(high, nibble), _mm_add_epi8(_mm_slli_epi16(tens, 3), _mm_slli_epi16(tens, 1)));
+
+		__m128i hundredths = _mm_and_si128(low, byteMask);
+		__m128i seconds = _mm_and_si128(_mm_srli_epi32(low, 8), byteMask);
+		__m128i minutes = _mm_and_si128(_mm_srli_epi32(low, 16), byteMask);
+		__m128i hours = _mm_srli_epi32(low, 24);
+		__m128i date = _mm_and_si128(_mm_srli_epi32(high, 8), byteMask);
+		__m128i month = _mm_and_si128(_mm_srli_epi32(high, 16), byteMask);
+		__m128i year = _mm_srli_epi32(high, 24);
+
+		__m128i monthValid = _mm_and_si128(_mm_cmpgt_epi32(month, _mm_setzero_si128()), _mm_cmpgt_epi32(thirteen, month));
+		month = _mm_blendv_epi8(one, month, monthValid);
+		date = _mm_max_epu32(date, one);
+
+		__m128i monthIndex = _mm_sub_epi32(month, one);
+		__m128i days = _mm_mullo_epi32(year, _mm_set1_epi32(365));
+		days = _mm_add_epi32(days, _mm_srli_epi32(_mm_add_epi32(year, three), 2));
+		days = _mm_add_epi32(days, _mm_mullo_epi32(monthIndex, _mm_set1_epi32(30)));
+		days = _mm_add_epi32(days, _mm_sub_epi32(_mm_shuffle_epi8(correction, _mm_or_si128(monthIndex, indexFill)), one));
+		days = _mm_add_epi32(days, _mm_sub_epi32(date, one));
+		__m128i leap = _mm_and_si128(_mm_cmpgt_epi32(month, two), _mm_cmpeq_epi32(_mm_and_si128(year, three), _mm_setzero_si128()));
+		days = _mm_sub_epi32(days, leap); //leap is all ones where a day has to be added
+
+		__m128i secs = _mm_mullo_epi32(days, _mm_set1_epi32(86400));
+		secs = _mm_add_epi32(secs, _mm_mullo_epi32(hours, _mm_set1_epi32(3600)));
+		secs = _mm_add_epi32(secs, _mm_mullo_epi32(minutes, _mm_set1_epi32(60)));
+		secs = _mm_add_epi32(secs, _mm_add_epi32(seconds, epoch));
+		__m128i tenths = _mm_mullo_epi32(hundredths, _mm_set1_epi32(10));
+
+		__m128i ms0 = _mm_add_epi64(_mm_mul_epu32(_mm_cvtepu32_epi64(secs), thousand), _mm_cvtepu32_epi64(tenths));
+		__m128i ms1 = _mm_add_epi64(_mm_mul_epu32(_mm_cvtepu32_epi64(_mm_srli_si128(secs, 8)), thousand), _mm_cvtepu32_epi64(_mm_srli_si128(tenths, 8)));
+		_mm_storeu_si128((__m128i *)(epochMs + i), ms0);
+		_mm_storeu_si128((__m128i *)(epochMs + i + 2), ms1);
+	}
+	imagesToEpochMsScalar(images + i * RV3032_IMAGE_LENGTH, epochMs + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void imagesToEpochMsAVX2(const uint8_t * images, uint64_t * epochMs, size_t count)
+{
+	const __m256i regroup = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	const __m256i lowMask = _mm256_set1_epi32(LOW_HALF_MASK);
+	const __m256i highMask = _mm256_set1_epi32(HIGH_HALF_MASK);
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	const __m256i correction = _mm256_setr_epi8(MONTH_CORRECTION, MONTH_CORRECTION);
+	const __m256i indexFill = _mm256_set1_epi32(0x80808000);
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i two = _mm256_set1_epi32(2);
+	const __m256i three = _mm256_set1_epi32(3);
+	const __m256i thirteen = _mm256_set1_epi32(13);
+	const __m256i epoch = _mm256_set1_epi32(RV3032_EPOCH_2000);
+	const __m256i thousand = _mm256_set1_epi32(1000);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const uint8_t * src = images + i * RV3032_IMAGE_LENGTH;
+		__m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *)src), regroup); //r0lo..r3lo r0hi..r3hi
+		__m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *)(src + 32)), regroup); //r4lo..r7lo r4hi..r7hi
+		__m256i low = _mm256_and_si256(_mm256_permute2x128_si256(a, b, 0x20), lowMask);
+		__m256i high = _mm256_and_si256(_mm256_permute2x128_si256(a, b, 0x31), highMask);
+
+		__m256i tens = _mm256_and_si256(_mm256_srli_epi16(low, 4), nibble);
+		low = _mm256_add_epi8(_mm256_and_si256(low, nibble), _mm256_add_epi8(_mm256_slli_epi16(tens, 3), _mm256_slli_epi16(tens, 1)));
+		tens = _mm256_and_si256(_mm256_srli_epi16(high, 4), nibble);
+		high = _mm256_add_epi8(_mm256_and_si256(high, nibble), _mm256_add_epi8(_mm256_slli_epi16(tens, 3), _mm256_slli_epi16(tens, 1)));
+
+		__m256i hundredths = _mm256_and_si256(low, byteMask);
+		__m256i seconds = _mm256_and_si256(_mm256_srli_epi32(low, 8), byteMask);
+		__m256i minutes = _mm256_and_si256(_mm256_srli_epi32(low, 16), byteMask);
+		__m256i hours = _mm256_srli_epi32(low, 24);
+		__m256i date = _mm256_and_si256(_mm256_srli_epi32(high, 8), byteMask);
+		__m256i month = _mm256_and_si256(_mm256_srli_epi32(high, 16), byteMask);
+		__m256i year = _mm256_srli_epi32(high, 24);
+
+		__m256i monthValid = _mm256_and_si256(_mm256_cmpgt_epi32(month, _mm256_setzero_si256()), _mm256_cmpgt_epi32(thirteen, month));
+		month = _mm256_blendv_epi8(one, month, monthValid);
+		date = _mm256_max_epu32(date, one);
+
+		__m256i monthIndex = _mm256_sub_epi32(month, one);
+		__m256i days = _mm256_mullo_epi32(year, _mm256_set1_epi32(365));
+		days = _mm256_add_epi32(days, _mm256_srli_epi32(_mm256_add_epi32(year, three), 2));
+		days = _mm256_add_epi32(days, _mm256_mullo_epi32(monthIndex, _mm256_set1_epi32(30)));
+		days = _mm256_add_epi32(days, _mm256_sub_epi32(_mm256_shuffle_epi8(correction, _mm256_or_si256(monthIndex, indexFill)), one));
+		days = _mm256_add_epi32(days, _mm256_sub_epi32(date, one));
+		__m256i leap = _mm256_and_si256(_mm256_cmpgt_epi32(month, two), _mm256_cmpeq_epi32(_mm256_and_si256(year, three), _mm256_setzero_si256()));
+		days = _mm256_sub_epi32(days, leap);
+
+		__m256i secs = _mm256_mullo_epi32(days, _mm256_set1_epi32(86400));
+		secs = _mm256_add_epi32(secs, _mm256_mullo_epi32(hours, _mm256_set1_epi32(3600)));
+		secs = _mm256_add_epi32(secs, _mm256_mullo_epi32(minutes, _mm256_set1_epi32(60)));
+		secs = _mm256_add_epi32(secs, _mm256_add_epi32(seconds, epoch));
+		__m256i tenths = _mm256_mullo_epi32(hundredths, _mm256_set1_epi32(10));
+
+		__m256i ms0 = _mm256_add_epi64(_mm256_mul_epu32(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(secs)), thousand), _mm256_cvtepu32_epi64(_mm256_castsi256_si128(tenths)));
+		__m256i ms1 = _mm256_add_epi64(_mm256_mul_epu32(_mm256_cvtepu32_epi64(_mm256_extracti128_si256(secs, 1)), thousand), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(tenths, 1)));
+		_mm256_storeu_si256((__m256i *)(epochMs + i), ms0);
+		_mm256_storeu_si256((__m256i *)(epochMs + i + 4), ms1);
+	}
+	imagesToEpochMsScalar(images + i * RV3032_IMAGE_LENGTH, epochMs + i, count - i);
+}
+
+#endif
+
+static bool kernelSupported(rv3032_kernel kernel)
+{
+#ifdef RV3032_BATCH_X86
+	switch (kernel)
+	{
+	case RV3032_KERNEL_AVX2:
+		return __builtin_cpu_supports("avx2");
+	case RV3032_KERNEL_SSE41:
+		return __builtin_cpu_supports("sse4.1");
+	default:
+		return true;
+	}
+#else
+	return kernel == RV3032_KERNEL_SCALAR;
+#endif
+}
+
+rv3032_kernel rv3032BestKernel()
+{
+	static int best = -1;
+	if (best < 0)
+	{
+		best = RV3032_KERNEL_SCALAR;
+		if (kernelSupported(RV3032_KERNEL_AVX2))
+			best = RV3032_KERNEL_AVX2;
+		else if (kernelSupported(RV3032_KERNEL_SSE41))
+			best = RV3032_KERNEL_SSE41;
+	}
+	return (rv3032_kernel)best;
+}
+
+const char * rv3032KernelName(rv3032_kernel kernel)
+{
+	switch (kernel)
+	{
+	case RV3032_KERNEL_AVX2:
+		return "avx2";
+	case RV3032_KERNEL_SSE41:
+		return "sse4.1";
+	default:
+		return "scalar";
+	}
+}
+
+void rv3032ImagesToEpochMs(const uint8_t * images, uint64_t * epochMs, size_t count)
+{
+	rv3032ImagesToEpochMs(rv3032BestKernel(), images, epochMs, count);
+}
+
+void rv3032ImagesToEpochMs(rv3032_kernel kernel, const uint8_t * images, uint64_t * epochMs, size_t count)
+{
+	if (kernelSupported(kernel) == false)
+		kernel = RV3032_KERNEL_SCALAR;
+
+	switch (kernel)
+	{
+#ifdef RV3032_BATCH_X86
+	case RV3032_KERNEL_AVX2:
+		imagesToEpochMsAVX2(images, epochMs, count);
+		break;
+	case RV3032_KERNEL_SSE41:
+		imagesToEpochMsSSE41(images, epochMs, count);
+		break;
+#endif
+	default:
+		imagesToEpochMsScalar(images, epochMs, count);
+		break;
+	}
+}
+
+void rv3032EpochMsToImages(const uint64_t * epochMs, uint8_t * images, size_t count)
+{
+	const uint64_t start = RV3032_EPOCH_2000 * 1000ULL;
+	for (size_t i = 0; i < count; i++)
+	{
+		uint64_t ms = epochMs[i] < start ? start : epochMs[i]; //The RTC can't go before 2000
+		rv3032HundredthsToTime((ms - start) / 10, images + i * RV3032_IMAGE_LENGTH);
+	}
+}
@@ -0,0 +1,39 @@
+/******************************************************************************
+rv3032_batch.h
+RV3032 Arduino Library
+
+Host side bulk conversion of logged RV-3032 time images (the 8 byte _time layout,
+see time_order) to UNIX epoch milliseconds and back.
+
+Image to epoch runs 8 records per step with AVX2 or 4 with SSE4.1 when the CPU has them,
+picked once at runtime, with a scalar fallback on every other target. All paths give the
+same result as rv3032TimeToHundredths() for every date from 2000 to 2099, and for raw
+images with a month outside 1-12 or date 0.
+Epoch to image is scalar.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "RV3032_Time.h"
+
+#define RV3032_IMAGE_LENGTH 8 // Bytes per time image, same as TIME_ARRAY_LENGTH
+
+enum rv3032_kernel {
+	RV3032_KERNEL_SCALAR,
+	RV3032_KERNEL_SSE41,
+	RV3032_KERNEL_AVX2,
+};
+
+rv3032_kernel rv3032BestKernel(); //Fastest kernel this CPU supports
+const char * rv3032KernelName(rv3032_kernel kernel);
+
+uint64_t rv3032ImageToEpochMs(const uint8_t * image); //Single record path, the reference for the batch kernels
+
+void rv3032ImagesToEpochMs(const uint8_t * images, uint64_t * epochMs, size_t count);
+void rv3032ImagesToEpochMs(rv3032_kernel kernel, const uint8_t * images, uint64_t * epochMs, size_t count); //Falls back to scalar if the kernel isn't supported
+void rv3032EpochMsToImages(const uint64_t * epochMs, uint8_t * images, size_t count);
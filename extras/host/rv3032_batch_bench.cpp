@@ -0,0 +1,140 @@
+/******************************************************************************
+rv3032_batch_bench.cpp
+RV3032 Arduino Library
+
+Checks the batch kernels in rv3032_batch.h bit for bit against the single record path
+for every date from 2000 to 2099 and for images a blank or corrupted RTC gives
+(all zero, months 13-31), then reports their throughput in records per second.
+
+  rv3032_batch_bench [records]
+
+Build:
+  c++ -O2 -I../../src -o rv3032_batch_bench rv3032_batch_bench.cpp rv3032_batch.cpp ../../src/RV3032_Time.cpp
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "rv3032_batch.h"
+
+#define DAYS_2000_TO_2099 36525
+#define TIMES_PER_DAY 4
+
+static const rv3032_kernel kernels[] = {RV3032_KERNEL_SCALAR, RV3032_KERNEL_SSE41, RV3032_KERNEL_AVX2};
+
+//Every date of the century at midnight, just before midnight and two times in between
+static std::vector<uint8_t> allDates()
+{
+	static const uint32_t times[TIMES_PER_DAY] = {0, 3723, 45296, 86399};
+	std::vector<uint8_t> images(DAYS_2000_TO_2099 * TIMES_PER_DAY * RV3032_IMAGE_LENGTH);
+	size_t n = 0;
+	for (uint32_t day = 0; day < DAYS_2000_TO_2099; day++)
+	{
+		for (uint8_t t = 0; t < TIMES_PER_DAY; t++, n++)
+		{
+			uint64_t hundredths = ((uint64_t)day * 86400 + times[t]) * 100 + (n % 100);
+			rv3032HundredthsToTime(hundredths, &images[n * RV3032_IMAGE_LENGTH]);
+		}
+	}
+	return images;
+}
+
+//Raw images that are not valid dates: all zero, and every month register value from 0x13 to 0x31
+//on a few dates, leap years and years ending a 4 year block included
+static std::vector<uint8_t> invalidImages()
+{
+	static const uint8_t years[] = {0x00, 0x03, 0x24, 0x99};
+	static const uint8_t dates[] = {0x00, 0x01, 0x29, 0x31};
+	std::vector<uint8_t> images(RV3032_IMAGE_LENGTH, 0);
+	for (uint8_t month = 0x13; month <= 0x31; month++)
+	{
+		for (uint8_t year : years)
+		{
+			for (uint8_t date : dates)
+			{
+				uint8_t image[RV3032_IMAGE_LENGTH] = {0x42, 0x59, 0x59, 0x23, 0x04, date, month, year};
+				images.insert(images.end(), image, image + RV3032_IMAGE_LENGTH);
+			}
+		}
+	}
+	return images;
+}
+
+static bool verify(rv3032_kernel kernel, const std::vector<uint8_t> &images, bool roundTrip)
+{
+	size_t count = images.size() / RV3032_IMAGE_LENGTH;
+	std::vector<uint64_t> epochMs(count);
+	rv3032ImagesToEpochMs(kernel, images.data(), epochMs.data(), count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		uint64_t expected = rv3032ImageToEpochMs(&images[i * RV3032_IMAGE_LENGTH]);
+		if (epochMs[i] != expected)
+		{
+			printf("%-7s mismatch at record %zu: %llu != %llu\n", rv3032KernelName(kernel), i, (unsigned long long)epochMs[i], (unsigned long long)expected);
+			return false;
+		}
+	}
+
+	if (roundTrip == false)
+		return true; //Invalid images don't map back to themselves
+
+	std::vector<uint8_t> back(images.size());
+	rv3032EpochMsToImages(epochMs.data(), back.data(), count);
+	if (memcmp(back.data(), images.data(), images.size()) != 0)
+	{
+		printf("%-7s round trip back to images failed\n", rv3032KernelName(kernel));
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char ** argv)
+{
+	size_t count = (argc > 1) ? strtoul(argv[1], NULL, 10) : (1 << 22);
+	printf("Best kernel on this CPU: %s\n", rv3032KernelName(rv3032BestKernel()));
+
+	std::vector<uint8_t> dates = allDates();
+	bool ok = true;
+	for (rv3032_kernel kernel : kernels)
+		ok &= verify(kernel, dates, true);
+	printf("Verification over 2000-2099: %s\n", ok ? "bit exact" : "FAILED");
+
+	std::vector<uint8_t> invalid = invalidImages();
+	bool invalidOk = true;
+	for (rv3032_kernel kernel : kernels)
+		invalidOk &= verify(kernel, invalid, false);
+	printf("Verification of invalid images: %s\n", invalidOk ? "bit exact" : "FAILED");
+	ok &= invalidOk;
+
+	std::vector<uint8_t> images(count * RV3032_IMAGE_LENGTH);
+	for (size_t i = 0; i < count; i++)
+		memcpy(&images[i * RV3032_IMAGE_LENGTH], &dates[(i * 7919 % (dates.size() / RV3032_IMAGE_LENGTH)) * RV3032_IMAGE_LENGTH], RV3032_IMAGE_LENGTH);
+	std::vector<uint64_t> epochMs(count);
+
+	for (rv3032_kernel kernel : kernels)
+	{
+		double best = 1e30;
+		for (int run = 0; run < 5; run++)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			rv3032ImagesToEpochMs(kernel, images.data(), epochMs.data(), count);
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			if (elapsed.count() < best)
+				best = elapsed.count();
+		}
+		printf("%-7s %8.1f M records/s\n", rv3032KernelName(kernel), count / best / 1e6);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	rv3032EpochMsToImages(epochMs.data(), images.data(), count);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	printf("%-7s %8.1f M records/s (epoch to image)\n", "scalar", count / elapsed.count() / 1e6);
+
+	return ok ? 0 : 1;
+}
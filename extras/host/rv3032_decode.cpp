@@ -0,0 +1,108 @@
+/******************************************************************************
+rv3032_decode.cpp
+RV3032 Arduino Library
+
+Host tool that turns binary timestamp logs written on the device back into ISO 8601.
+
+  rv3032_decode [--packed] [file]
+
+Without --packed the input is a stream written by RV3032TimeEncoder, with --packed it is
+a sequence of 5 byte records from RV3032::getPackedTimestamp(). Reads stdin if no file is given.
+Prints one yyyy-mm-ddThh:mm:ss.hh line per record.
+
+Build:
+  c++ -O2 -I../../src -o rv3032_decode rv3032_decode.cpp ../../src/RV3032_Time.cpp
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "RV3032_Time.h"
+
+static void printTimestamp(uint64_t hundredths)
+{
+	uint8_t time[8];
+	rv3032HundredthsToTime(hundredths, time);
+	printf("20%02d-%02d-%02dT%02d:%02d:%02d.%02d\n", rv3032BCDtoDEC(time[7]), rv3032BCDtoDEC(time[6]), rv3032BCDtoDEC(time[5]),
+		rv3032BCDtoDEC(time[3]), rv3032BCDtoDEC(time[2]), rv3032BCDtoDEC(time[1]), rv3032BCDtoDEC(time[0]));
+}
+
+int main(int argc, char ** argv)
+{
+	bool packed = false;
+	const char * path = NULL;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--packed") == 0)
+			packed = true;
+		else
+			path = argv[i];
+	}
+
+	FILE * in = stdin;
+	if (path != NULL && (in = fopen(path, "rb")) == NULL)
+	{
+		perror(path);
+		return 1;
+	}
+
+	uint8_t buffer[4096];
+	size_t fill = 0;
+	size_t bytesRead;
+	unsigned long skipped = 0;
+	RV3032TimeDecoder decoder;
+
+	while ((bytesRead = fread(buffer + fill, 1, sizeof(buffer) - fill, in)) > 0 || fill > 0)
+	{
+		fill += bytesRead;
+		bool atEnd = (bytesRead == 0);
+		size_t pos = 0;
+
+		if (packed)
+		{
+			for (; fill - pos >= RV3032_PACKED_LENGTH; pos += RV3032_PACKED_LENGTH)
+				printTimestamp(rv3032Unpack40(buffer + pos));
+			if (atEnd && fill - pos > 0)
+			{
+				fprintf(stderr, "Trailing %u bytes ignored\n", (unsigned)(fill - pos));
+				pos = fill;
+			}
+		}
+		else
+		{
+			while (pos < fill)
+			{
+				size_t left = fill - pos;
+				uint64_t hundredths;
+				bool valid;
+				uint8_t used = decoder.decode(buffer + pos, left > RV3032_STREAM_MAX_LENGTH ? RV3032_STREAM_MAX_LENGTH : left, hundredths, valid);
+				if (used == 0)
+				{
+					if (left < RV3032_STREAM_MAX_LENGTH && !atEnd)
+						break; //Wait for the rest of the record
+					pos++; //Corrupt byte, resync on the next keyframe
+					skipped++;
+					continue;
+				}
+				pos += used;
+				if (valid)
+					printTimestamp(hundredths);
+				else
+					skipped++;
+			}
+			if (atEnd)
+				pos = fill;
+		}
+
+		memmove(buffer, buffer + pos, fill - pos);
+		fill -= pos;
+	}
+
+	if (skipped > 0)
+		fprintf(stderr, "%lu records or bytes skipped before a keyframe\n", skipped);
+	if (in != stdin)
+		fclose(in);
+	return 0;
+}
@@ -0,0 +1,178 @@
+/******************************************************************************
+rv3032_latency_sim.cpp
+RV3032 Arduino Library
+
+Runs RV3032LatencyProfiler against a simulated RV-3032 on a 100 kHz bus with a crystal
+that runs 50 ppm fast. Events hit EVI at random phases of the hundredths tick, and the
+handler runs after a latency drawn from a known mix. The checks compare what the profiler
+reports with what was injected, and cover the histogram and clock map on their own.
+Exits with 1 if any check fails.
+
+  rv3032_latency_sim [events]
+
+Build:
+  c++ -O2 -DARDUINO=10813 -Ishim -I../../src -o rv3032_latency_sim rv3032_latency_sim.cpp shim/shim.cpp shim/SimDevices.cpp ../../src/RV3032_Latency.cpp ../../src/SparkFun_RV3032.cpp ../../src/RV_ClockCore.cpp ../../src/RV3032_Time.cpp ../../src/RV3032_TimeZone.cpp ../../src/RV3032_Power.cpp ../../src/RV3032_Trace.cpp
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "SimDevices.h"
+#include "RV3032_Latency.h"
+
+#define BUS_HZ           100000
+#define START_TIME       (757382400ULL * 100) // 2024-01-01 00:00:00.00
+#define RTC_PPM          50
+#define DEFAULT_EVENTS   3000
+#define MEAN_TOLERANCE   300 // us, the +-5 ms capture error averages down to ~50 us over 3000 events, sync points are +-0.3 ms
+#define HANDLER_MICROS   800 // Time the handler body takes before loop() runs update()
+
+static bool ok = true;
+
+static void check(bool condition, const char * what)
+{
+	printf("%-62s %s\n", what, condition ? "ok" : "FAILED");
+	ok &= condition;
+}
+
+static uint32_t seed = 12345;
+
+static uint32_t random(uint32_t range)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) % range;
+}
+
+static void printHistogram(RV3032LatencyHistogram &histogram)
+{
+	uint32_t most = 1;
+	for (uint8_t bin = 0; bin < histogram.getBins(); bin++)
+		if (histogram.getBin(bin) > most)
+			most = histogram.getBin(bin);
+	for (uint8_t bin = 0; bin < histogram.getBins(); bin++)
+	{
+		if (histogram.getBin(bin) == 0)
+			continue;
+		printf("  %6ld us %6lu ", (long)histogram.getBinStart(bin), (unsigned long)histogram.getBin(bin));
+		for (uint32_t i = 0; i < histogram.getBin(bin) * 50 / most; i++)
+			putchar('#');
+		putchar('\n');
+	}
+	printf("  under %lu over %lu, min %ld mean %ld p50 %ld p90 %ld p99 %ld max %ld us\n", (unsigned long)histogram.getUnderflow(),
+		(unsigned long)histogram.getOverflow(), (long)histogram.getMin(), (long)histogram.getMean(), (long)histogram.getPercentile(50),
+		(long)histogram.getPercentile(90), (long)histogram.getPercentile(99), (long)histogram.getMax());
+}
+
+static void checkHistogram()
+{
+	RV3032LatencyHistogram histogram(-1000, 500);
+	const int32_t values[] = {-2000, -1000, -1, 0, 499, 500, 1200, 14999, 15000, 40000};
+	for (uint8_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+		histogram.add(values[i]);
+	check(histogram.getCount() == 10 && histogram.getUnderflow() == 1 && histogram.getOverflow() == 2, "histogram: count, underflow and overflow");
+	check(histogram.getBin(0) == 1 && histogram.getBin(1) == 1 && histogram.getBin(2) == 2 && histogram.getBin(3) == 1
+		&& histogram.getBin(4) == 1 && histogram.getBin(31) == 1, "histogram: values land in the right bins");
+	check(histogram.getMin() == -2000 && histogram.getMax() == 40000 && histogram.getMean() == 6920, "histogram: min, max and mean");
+	check(histogram.getPercentile(0) == -2000 && histogram.getPercentile(10) == -2000 && histogram.getPercentile(50) == 500
+		&& histogram.getPercentile(70) == 1500 && histogram.getPercentile(100) == 40000, "histogram: percentiles");
+	histogram.reset();
+	check(histogram.getCount() == 0 && histogram.getMean() == 0 && histogram.getPercentile(50) == 0, "histogram: reset");
+}
+
+static void checkClockMap()
+{
+	//MCU 100 ppm slow against the RTC, and micros() wrapping between the points
+	RV3032ClockMap map;
+	uint32_t micros;
+	check(map.toMicros(100, micros) == false, "clock map: nothing to map with before a point");
+	map.addPoint(1000, 0xFFFF0000UL);
+	check(map.toMicros(1100, micros) && micros == (uint32_t)(0xFFFF0000UL + 1000000), "clock map: one point assumes equal clocks");
+	for (uint32_t i = 1; i < 6; i++)
+		map.addPoint(1000 + i * 1000, 0xFFFF0000UL + i * 9999000);
+	check(map.getPoints() == RV3032_LATENCY_SYNC_POINTS, "clock map: keeps the newest points");
+	check(map.getDriftPpm() == -100, "clock map: drift");
+	check(map.toMicros(3500, micros) && micros == (uint32_t)(0xFFFF0000UL + 24997500), "clock map: interpolates between points");
+	check(map.toMicros(7000, micros) && micros == (uint32_t)(0xFFFF0000UL + 59994000), "clock map: extrapolates past the last point");
+}
+
+//One event: random gap with update() polled in it, the edge, the injected latency, then the handler
+static void event(RV3032Sim &sim, RV3032LatencyProfiler &profiler, uint32_t latency)
+{
+	shimAdvanceMicros(20000 + random(200000));
+	profiler.update();
+	shimAdvanceMicros(random(10000));
+	sim.triggerEvent();
+	shimAdvanceMicros(latency);
+	profiler.handlerRan();
+	shimAdvanceMicros(HANDLER_MICROS);
+	profiler.update();
+}
+
+int main(int argc, char ** argv)
+{
+	uint32_t events = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_EVENTS;
+
+	checkHistogram();
+	checkClockMap();
+
+	shimSetBusClock(BUS_HZ);
+	RV3032Sim sim;
+	Wire.attach(RV3032_ADDR, &sim);
+	sim.setTime(START_TIME);
+	sim.setDriftPpm(RTC_PPM);
+
+	RV3032 rtc;
+	rtc.begin();
+	RV3032LatencyHistogram histogram;
+	RV3032LatencyProfiler profiler(rtc, histogram);
+	check(profiler.begin(), "profiler begins and syncs");
+
+	//Mostly quick, sometimes held up by another interrupt
+	uint64_t injected = 0;
+	for (uint32_t i = 0; i < events; i++)
+	{
+		uint32_t latency = random(10) < 8 ? 150 + random(100) : 2500 + random(500);
+		injected += latency;
+		event(sim, profiler, latency);
+	}
+	int32_t trueMean = injected / events;
+	printf("Mixed latencies, injected mean %ld us\n", (long)trueMean);
+	printHistogram(histogram);
+	check(profiler.getEvents() == events && profiler.getMissed() == 0, "every event measured");
+	check(profiler.getClockMap().getPoints() == RV3032_LATENCY_SYNC_POINTS, "clock map kept fresh by update()");
+	check(abs(profiler.getClockMap().getDriftPpm() + RTC_PPM) <= 10, "MCU drift against the RTC found (-50 +-10 ppm)");
+	check(abs(histogram.getMean() - trueMean) <= MEAN_TOLERANCE, "mean latency within 300 us of the injected mean");
+	check(histogram.getUnderflow() == 0 && histogram.getOverflow() == 0, "nothing outside the bins");
+
+	//A constant latency spreads over the one hundredth box around it
+	const uint32_t constant = 4000;
+	histogram.reset();
+	for (uint32_t i = 0; i < events; i++)
+		event(sim, profiler, constant);
+	printf("Constant latency of %lu us\n", (unsigned long)constant);
+	printHistogram(histogram);
+	check(abs(histogram.getMean() - (int32_t)constant) <= MEAN_TOLERANCE, "constant latency: mean");
+	check(histogram.getMin() >= (int32_t)constant - 5500 && histogram.getMax() <= (int32_t)constant + 5500, "constant latency: spread no wider than one hundredth");
+	check(abs(histogram.getPercentile(50) - (int32_t)constant) <= 1000, "constant latency: median within a bin");
+
+	//Two edges before the handler: the first is measured, the second counted as missed
+	uint32_t measured = profiler.getEvents();
+	sim.triggerEvent();
+	shimAdvanceMicros(300);
+	sim.triggerEvent();
+	profiler.handlerRan();
+	profiler.handlerRan();
+	check(profiler.update() && profiler.getEvents() == measured + 1 && profiler.getMissed() == 1, "second event before update() counted as missed");
+
+	//The MCU sees an event the RTC didn't capture
+	profiler.handlerRan();
+	check(profiler.update() == false && profiler.getMissed() == 2, "handler without a capture counted as missed");
+
+	sim.setResponding(false);
+	check(profiler.sync() == false, "sync fails when the RTC doesn't answer");
+
+	printf(ok ? "PASS\n" : "FAIL\n");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/******************************************************************************
+rv3032_mux_sim.cpp
+RV3032 Arduino Library
+
+Runs RV3032Mux against simulated RV-3032s behind a simulated TCA9548A on a 100 kHz
+bus, and checks the channel switch count, the skew correction, the majority vote and
+the health reporting for clocks that drift, jump, lose power or stop answering, and that
+the mux writes reach the energy meter and the trace recorder.
+Exits with 1 if any check fails.
+
+  rv3032_mux_sim
+
+Build:
+  c++ -O2 -DARDUINO=10813 -Ishim -I../../src -o rv3032_mux_sim rv3032_mux_sim.cpp shim/shim.cpp shim/SimDevices.cpp ../../src/RV3032_Mux.cpp ../../src/SparkFun_RV3032.cpp ../../src/RV_ClockCore.cpp ../../src/RV3032_Time.cpp ../../src/RV3032_TimeZone.cpp ../../src/RV3032_Power.cpp ../../src/RV3032_Trace.cpp
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include <stdio.h>
+#include "SimDevices.h"
+#include "RV3032_Mux.h"
+
+#define BUS_HZ           100000
+#define START_TIME       (757382400ULL * 100) // 2024-01-01 00:00:00.00
+#define CLOCKS           8
+
+static bool ok = true;
+
+static void check(bool condition, const char * what)
+{
+	printf("%-58s %s\n", what, condition ? "ok" : "FAILED");
+	ok &= condition;
+}
+
+static void printSnapshot(const RV3032MuxSnapshot &snap)
+{
+	printf("  valid %02X agree %02X skew %lu ms majority %d mux writes %u\n", snap.validMask, snap.agreeMask,
+		(unsigned long)snap.skewMs, snap.majority, snap.channelWrites);
+}
+
+int main()
+{
+	shimSetBusClock(BUS_HZ);
+
+	I2CMuxSim muxSim(Wire);
+	RV3032Sim clocks[CLOCKS];
+	RV3032Mux mux;
+	check(mux.begin(), "mux answers");
+
+	for (uint8_t i = 0; i < CLOCKS; i++)
+	{
+		muxSim.attach(i, RV3032_ADDR, &clocks[i]);
+		clocks[i].setTime(START_TIME);
+		check(mux.addDevice(i) == i, "device added");
+	}
+	check(mux.addDevice(3) == -1, "second device on a channel refused");
+
+	//Eight clocks in step: read one after the other, the last one is read ~10 ms after the first
+	RV3032MuxSnapshot snap;
+	shimAdvanceMicros(123456);
+	check(mux.snapshot(snap), "snapshot of eight clocks");
+	printSnapshot(snap);
+	check(snap.validMask == 0xFF && snap.agreeMask == 0xFF && snap.majority, "all clocks valid and agreeing");
+	check(snap.skewMs <= 10, "sequential reads corrected to one instant (skew <= 10 ms)");
+	check(snap.channelWrites == CLOCKS - 1, "one mux write per device, none for the selected one");
+	printf("  pass took %lu us\n", (unsigned long)(snap.readMicros[mux.getSelectedChannel()] - snap.readMicros[0]));
+
+	uint32_t writes = muxSim.getWrites();
+	check(mux.select(mux.getSelectedChannel()) && muxSim.getWrites() == writes, "reselecting the current channel costs nothing");
+
+	//Mux writes go to the same energy meter and trace as the RTC transactions
+	uint8_t traceBuffer[2048];
+	RV3032TraceRecorder recorder(traceBuffer, sizeof(traceBuffer));
+	RV3032EnergyMeter meter(BUS_HZ);
+	mux.setEnergyMeter(&meter);
+	mux.setTraceRecorder(&recorder);
+	meter.beginCycle(micros());
+	check(mux.snapshot(snap), "snapshot with a meter and a recorder");
+	meter.endCycle(micros());
+	mux.setEnergyMeter(NULL);
+	mux.setTraceRecorder(NULL);
+	RV3032TraceReader reader(recorder.getData(), recorder.getLength());
+	RV3032TraceRecord record;
+	uint32_t traced = 0, tracedMux = 0;
+	while (reader.next(record))
+	{
+		traced++;
+		if (record.address == RV3032_MUX_ADDR && record.read == false && record.length == 1)
+			tracedMux++;
+	}
+	printf("  %lu transactions traced, %lu of them mux writes\n", (unsigned long)traced, (unsigned long)tracedMux);
+	check(tracedMux == snap.channelWrites && traced == meter.getCycleTransactions(), "mux writes traced and metered");
+
+	//One clock jumps 2.5 s, one drifts 500 ppm for 100 s, one stops answering, one reports lost power
+	clocks[2].setTime(clocks[2].getTime() + 250);
+	clocks[4].setDriftPpm(500);
+	shimAdvanceMicros(100000000);
+	clocks[5].setResponding(false);
+	clocks[6].registerAt(RV3032_STATUS) |= (1 << STATUS_VLF);
+
+	check(mux.snapshot(snap), "snapshot with faults");
+	printSnapshot(snap);
+	check(snap.validMask == 0x9F, "silent and low voltage clocks excluded");
+	check(snap.agreeMask == 0x8B && snap.majority, "jumped and drifting clocks outvoted");
+	check(snap.skewMs >= 2490 && snap.skewMs <= 2510, "skew reports the 2.5 s jump");
+	uint64_t expected = clocks[0].getTime() - (micros() - snap.readMicros[0]) / 10000;
+	check(snap.votedHundredths + 1 >= expected && snap.votedHundredths <= expected + 1, "voted time matches the good clocks");
+	check(!mux.isHealthy(2) && !mux.isHealthy(4) && !mux.isHealthy(6), "outvoted and low voltage clocks unhealthy");
+	check(mux.isHealthy(0) && mux.isHealthy(7), "good clocks healthy");
+	check(mux.isHealthy(5), "one missed read is tolerated");
+
+	mux.snapshot(snap);
+	mux.snapshot(snap);
+	check(!mux.isHealthy(5) && mux.getHealth(5).consecutiveFailures == 3, "three missed reads make a device unhealthy");
+	check(mux.getHealth(5).failures == 3 && mux.getHealth(2).outvoted == 3, "failures and outvotes counted");
+
+	clocks[5].setResponding(true);
+	check(mux.checkDevice(5) && mux.isHealthy(5), "device recovers once it answers");
+
+	//Only two clocks left and they disagree: no majority, nobody is blamed
+	RV3032Mux pair;
+	pair.begin();
+	pair.addDevice(0);
+	pair.addDevice(2);
+	check(pair.snapshot(snap) && !snap.majority, "two disagreeing clocks have no majority");
+	check(pair.isHealthy(0) && pair.isHealthy(1), "without a majority nobody is outvoted");
+
+	printf(ok ? "PASS\n" : "FAIL\n");
+	return ok ? 0 : 1;
+}
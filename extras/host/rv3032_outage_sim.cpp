@@ -0,0 +1,98 @@
+/******************************************************************************
+rv3032_outage_sim.cpp
+RV3032 Arduino Library
+
+Runs getOutageRecord() against a simulated RV-3032 through boots without an outage
+(capture blank or left with stale data), outages on the backup supply, an outage that
+reset the chip and a capture with a corrupt month. Exits with 1 if any check fails.
+
+  rv3032_outage_sim
+
+Build:
+  c++ -O2 -DARDUINO=10813 -Ishim -I../../src -o rv3032_outage_sim rv3032_outage_sim.cpp shim/shim.cpp shim/SimDevices.cpp ../../src/SparkFun_RV3032.cpp ../../src/RV_ClockCore.cpp ../../src/RV3032_Time.cpp ../../src/RV3032_TimeZone.cpp ../../src/RV3032_Power.cpp ../../src/RV3032_Trace.cpp
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include <stdio.h>
+#include "SimDevices.h"
+#include "SparkFun_RV3032.h"
+
+#define START_TIME       (757382400ULL * 100) // 2024-01-01 00:00:00.00
+#define START_EPOCH      (RV3032_EPOCH_2000 + 757382400UL)
+
+static bool ok = true;
+
+static void check(bool condition, const char * what)
+{
+	printf("%-62s %s\n", what, condition ? "ok" : "FAILED");
+	ok &= condition;
+}
+
+static void printRecord(const RV3032OutageRecord &record)
+{
+	printf("  outage %d switched %d trusted %d known %d drops %u start %lu duration %lu\n", record.outage,
+		record.switchedOver, record.timeTrusted, record.startKnown, record.drops, (unsigned long)record.start,
+		(unsigned long)record.duration);
+}
+
+//Capture registers 0x27-0x2D: hundredths, seconds, minutes, hours, date, month, year
+static void setCapture(RV3032Sim &sim, uint8_t month)
+{
+	const uint8_t capture[EVI_CAPTURE_LENGTH - 1] = {0x50, 0x30, 0x15, 0x00, 0x01, month, 0x24};
+	for (uint8_t i = 0; i < EVI_CAPTURE_LENGTH - 1; i++)
+		sim.registerAt(RV3032_EVI_COUNT + 1 + i) = capture[i];
+}
+
+int main()
+{
+	RV3032Sim sim;
+	Wire.attach(RV3032_ADDR, &sim);
+	sim.setTime(START_TIME);
+
+	RV3032 rtc;
+	check(rtc.begin(), "rtc answers");
+	check(rtc.enableOutageCapture(), "outage capture enabled");
+
+	//No outage, blank capture: month 0 must not be decoded
+	RV3032OutageRecord record;
+	check(rtc.getOutageRecord(record), "record read without an outage");
+	printRecord(record);
+	check(!record.outage && record.timeTrusted && record.drops == 0, "no outage, time trusted");
+	check(record.start == 0 && !record.startKnown && record.duration == 0, "blank capture not decoded");
+
+	//No outage, capture left with a valid looking stamp from before the last clear
+	setCapture(sim, 0x01);
+	check(rtc.getOutageRecord(record) && record.drops == 0 && record.start == 0 && !record.startKnown,
+		"stale capture ignored without a drop");
+
+	//Outage of 3725 s on the backup supply
+	shimAdvanceMicros(5000000);
+	sim.powerOutage(3725ULL * 1000000);
+	check(rtc.getOutageRecord(record), "record read after an outage");
+	printRecord(record);
+	check(record.outage && record.switchedOver && record.timeTrusted && record.drops == 1, "outage on the backup supply");
+	check(record.startKnown && record.start == START_EPOCH + 5 && record.duration == 3725, "start and duration from the capture");
+
+	//A drop counted but the stamp has a month the chip can't hold
+	setCapture(sim, 0x15);
+	check(rtc.getOutageRecord(record) && record.drops == 1, "record read with a corrupt capture");
+	check(record.outage && record.start == 0 && !record.startKnown && record.duration == 0, "month 15 not decoded");
+	setCapture(sim, 0x00);
+	check(rtc.getOutageRecord(record) && record.start == 0 && !record.startKnown, "month 0 not decoded");
+
+	//Cleared, then an outage with no backup: the chip resets and the time is lost
+	check(rtc.clearOutageRecord(), "record cleared");
+	check(rtc.getOutageRecord(record) && !record.outage && record.drops == 0 && record.start == 0, "nothing left after the clear");
+	sim.powerOutage(1000000, false);
+	check(rtc.getOutageRecord(record), "record read after a reset");
+	printRecord(record);
+	check(!record.timeTrusted && !record.startKnown && record.duration == 0, "reset without a backup, time not trusted");
+
+	sim.setResponding(false);
+	check(rtc.getOutageRecord(record) == false, "silent RTC reported");
+
+	printf(ok ? "PASS\n" : "FAIL\n");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,445 @@
+/******************************************************************************
+rv3032_replay.cpp
+RV3032 Arduino Library
+
+Host tool for bus traces written by RV3032TraceRecorder (see RV3032_Trace.h).
+
+  rv3032_replay [--bus hz] trace                 Transactions, bytes and time per tagged call
+  rv3032_replay [--bus hz] old new               The same side by side, and the first transaction that differs
+  rv3032_replay [--bus hz] --drive trace [out]   Runs the tagged calls of trace through this version of the
+                                                 library against the recorded responses, compares the new
+                                                 trace with the old one and writes it to out
+  rv3032_replay [--bus hz] --record out          Writes a sample trace from a simulated RV-3032 and fails
+                                                 if a call in it went unrecorded
+
+A trace is the binary the recorder produces, or the same bytes as hex text as printed by
+Example15-Bus_Trace. Transactions before the first marker count as "untagged".
+Time per call runs from its marker to the end of its last transaction, the length of a
+transaction on the wire is worked out for a bus at --bus Hz (100000 by default).
+With --drive the gaps between calls are kept and the bus is simulated at --bus Hz, so
+the timing difference is the library's, not the host's.
+
+Build:
+  c++ -O2 -DARDUINO=10813 -Ishim -I../../src -o rv3032_replay rv3032_replay.cpp shim/shim.cpp shim/SimDevices.cpp ../../src/RV3032_Trace.cpp ../../src/SparkFun_RV3032.cpp ../../src/RV_ClockCore.cpp ../../src/RV3032_Time.cpp ../../src/RV3032_TimeZone.cpp ../../src/RV3032_Power.cpp
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "SimDevices.h"
+#include "SparkFun_RV3032.h"
+
+#define DEFAULT_BUS_HZ   100000
+#define TAGS             256
+#define RECORD_BUFFER    4096
+#define START_TIME       (757382400ULL * 100) // 2024-01-01 00:00:00.00
+
+typedef std::vector<uint8_t> Trace;
+
+struct TagStats
+{
+	uint32_t calls;
+	uint32_t transactions;
+	uint32_t bytes; //On the wire, address byte included
+	uint64_t micros;
+};
+
+static uint32_t busHz = DEFAULT_BUS_HZ;
+
+static const char * tagName(uint8_t tag)
+{
+	switch (tag)
+	{
+	case 0: return "untagged";
+	case TRACE_TAG_BEGIN: return "begin";
+	case TRACE_TAG_UPDATE_TIME: return "updateTime";
+	case TRACE_TAG_CLEAR_FLAGS: return "clearAllInterruptFlags";
+	case TRACE_TAG_DRAIN_EVI: return "drainEVIEvents";
+	case TRACE_TAG_TIMESTAMP: return "stringTimestamp";
+	case TRACE_TAG_CALIBRATION: return "getCalibrationOffsetSteps";
+	case TRACE_TAG_SAVE_CONFIG: return "saveConfig";
+	}
+	static char name[16];
+	snprintf(name, sizeof(name), "tag 0x%02X", tag);
+	return name;
+}
+
+//Start, address, ack per byte and stop
+static uint64_t wireMicros(uint8_t length)
+{
+	return (11 + 9 * (uint64_t)(length + 1)) * 1000000 / busHz;
+}
+
+//Binary if it starts with the magic, otherwise hex digits with anything in between ignored
+static bool load(const char * path, Trace &trace)
+{
+	FILE * in = fopen(path, "rb");
+	if (in == NULL)
+	{
+		perror(path);
+		return false;
+	}
+	Trace raw;
+	uint8_t buffer[4096];
+	size_t bytesRead;
+	while ((bytesRead = fread(buffer, 1, sizeof(buffer), in)) > 0)
+		raw.insert(raw.end(), buffer, buffer + bytesRead);
+	fclose(in);
+
+	trace.clear();
+	if (raw.size() >= RV3032_TRACE_MAGIC_LENGTH && memcmp(raw.data(), RV3032_TRACE_MAGIC, RV3032_TRACE_MAGIC_LENGTH) == 0)
+	{
+		trace = raw;
+		return true;
+	}
+	int high = -1;
+	for (size_t i = 0; i < raw.size(); i++)
+	{
+		if (isxdigit(raw[i]) == false)
+			continue;
+		int digit = isdigit(raw[i]) ? raw[i] - '0' : tolower(raw[i]) - 'a' + 10;
+		if (high < 0)
+			high = digit;
+		else
+		{
+			trace.push_back(high << 4 | digit);
+			high = -1;
+		}
+	}
+	if (trace.size() < RV3032_TRACE_MAGIC_LENGTH || memcmp(trace.data(), RV3032_TRACE_MAGIC, RV3032_TRACE_MAGIC_LENGTH) != 0)
+	{
+		fprintf(stderr, "%s: not a trace\n", path);
+		return false;
+	}
+	return true;
+}
+
+static bool save(const char * path, const Trace &trace)
+{
+	FILE * out = fopen(path, "wb");
+	if (out == NULL || fwrite(trace.data(), 1, trace.size(), out) != trace.size())
+	{
+		perror(path);
+		return false;
+	}
+	fclose(out);
+	return true;
+}
+
+static void summarise(const Trace &trace, TagStats * stats)
+{
+	memset(stats, 0, sizeof(TagStats) * TAGS);
+	RV3032TraceReader reader(trace.data(), trace.size());
+	RV3032TraceRecord record;
+	uint8_t tag = 0;
+	uint64_t callStart = 0; //End of what has been counted of the current call
+	while (reader.next(record))
+	{
+		if (record.marker == true)
+		{
+			tag = record.tag;
+			callStart = record.time;
+			stats[tag].calls++;
+			continue;
+		}
+		TagStats &s = stats[tag];
+		s.transactions++;
+		s.bytes += record.length + 1;
+		if (tag == 0)
+			continue;
+		uint64_t end = record.time + wireMicros(record.length);
+		s.micros += end - callStart; //Adds up to marker to end of the last transaction
+		callStart = end;
+	}
+	if (reader.isTruncated())
+		printf("(trace ends in the middle of a record)\n");
+}
+
+static double perCall(uint64_t total, uint32_t calls)
+{
+	return calls ? (double)total / calls : (double)total;
+}
+
+static void printOne(const TagStats * stats)
+{
+	printf("%-26s %7s %12s %10s %10s\n", "call", "calls", "trans/call", "bytes/call", "us/call");
+	for (int tag = 0; tag < TAGS; tag++)
+	{
+		const TagStats &s = stats[tag];
+		if (s.calls == 0 && s.transactions == 0)
+			continue;
+		printf("%-26s %7lu %12.2f %10.2f %10.1f\n", tagName(tag), (unsigned long)s.calls, perCall(s.transactions, s.calls),
+			perCall(s.bytes, s.calls), perCall(s.micros, s.calls));
+	}
+}
+
+static void printBoth(const TagStats * a, const TagStats * b)
+{
+	printf("%-26s %11s %15s %15s %21s\n", "call", "calls", "trans/call", "bytes/call", "us/call");
+	for (int tag = 0; tag < TAGS; tag++)
+	{
+		if (a[tag].calls == 0 && a[tag].transactions == 0 && b[tag].calls == 0 && b[tag].transactions == 0)
+			continue;
+		double usA = perCall(a[tag].micros, a[tag].calls);
+		double usB = perCall(b[tag].micros, b[tag].calls);
+		char change[16] = "";
+		if (usA > 0)
+			snprintf(change, sizeof(change), "%+.0f%%", (usB - usA) * 100 / usA);
+		printf("%-26s %5lu %5lu %7.2f %7.2f %7.2f %7.2f %8.1f %8.1f %5s\n", tagName(tag),
+			(unsigned long)a[tag].calls, (unsigned long)b[tag].calls,
+			perCall(a[tag].transactions, a[tag].calls), perCall(b[tag].transactions, b[tag].calls),
+			perCall(a[tag].bytes, a[tag].calls), perCall(b[tag].bytes, b[tag].calls), usA, usB, change);
+	}
+}
+
+static void printRecord(const char * label, const RV3032TraceRecord &record)
+{
+	printf("  %s 0x%02X %-5s %s", label, record.address, record.read ? "read" : "write", record.ack ? "" : "NACK ");
+	for (uint8_t i = 0; i < record.length; i++)
+		printf("%02X ", record.data[i]);
+	printf("\n");
+}
+
+//Reads may return different data, only what the library sends and how much it asks for count
+static bool sameRequest(const RV3032TraceRecord &a, const RV3032TraceRecord &b)
+{
+	if (a.address != b.address || a.read != b.read || a.length != b.length)
+		return false;
+	return a.read == true || memcmp(a.data, b.data, a.length) == 0;
+}
+
+static bool nextTransaction(RV3032TraceReader &reader, RV3032TraceRecord &record, uint8_t &tag)
+{
+	while (reader.next(record))
+	{
+		if (record.marker == false)
+			return true;
+		tag = record.tag;
+	}
+	return false;
+}
+
+static void firstDifference(const Trace &a, const Trace &b)
+{
+	RV3032TraceReader readerA(a.data(), a.size());
+	RV3032TraceReader readerB(b.data(), b.size());
+	RV3032TraceRecord recordA, recordB;
+	uint8_t tagA = 0, tagB = 0;
+	for (uint32_t n = 0; ; n++)
+	{
+		bool moreA = nextTransaction(readerA, recordA, tagA);
+		bool moreB = nextTransaction(readerB, recordB, tagB);
+		if (moreA == false && moreB == false)
+		{
+			printf("Same transactions, %lu of them\n", (unsigned long)n);
+			return;
+		}
+		if (moreA == true && moreB == true && sameRequest(recordA, recordB))
+			continue;
+		printf("First difference at transaction %lu:\n", (unsigned long)n);
+		if (moreA == true)
+		{
+			printf("  %s\n", tagName(tagA));
+			printRecord("old", recordA);
+		}
+		else
+			printf("  old has no more transactions\n");
+		if (moreB == true)
+		{
+			printf("  %s\n", tagName(tagB));
+			printRecord("new", recordB);
+		}
+		else
+			printf("  new has no more transactions\n");
+		return;
+	}
+}
+
+static Trace * flushTarget = NULL;
+
+static void flushToTrace(const uint8_t * data, uint16_t len)
+{
+	flushTarget->insert(flushTarget->end(), data, data + len);
+}
+
+//One call of the API the tag stands for, false if the tag has none
+static bool drive(RV3032 &rtc, uint8_t tag)
+{
+	static RV3032EventBuffer events;
+	static RV3032ConfigImage image;
+	switch (tag)
+	{
+	case TRACE_TAG_BEGIN: rtc.begin(); break;
+	case TRACE_TAG_UPDATE_TIME: rtc.updateTime(); break;
+	case TRACE_TAG_CLEAR_FLAGS: rtc.clearAllInterruptFlags(); break;
+	case TRACE_TAG_DRAIN_EVI: rtc.drainEVIEvents(events); events.clear(); break;
+	case TRACE_TAG_TIMESTAMP: rtc.stringTimestamp(); break;
+	case TRACE_TAG_CALIBRATION: rtc.getCalibrationOffsetSteps(); break;
+	case TRACE_TAG_SAVE_CONFIG: rtc.saveConfig(image); break;
+	default: return false;
+	}
+	return true;
+}
+
+static int driveTrace(const Trace &old, const char * outPath)
+{
+	RV3032 rtc;
+	rtc.begin(); //Sets up the port in case the trace doesn't start with begin(), before the device is there so no recorded probe is used up
+
+	TraceReplaySim device(old.data(), old.size(), RV3032_ADDR);
+	Wire.attach(RV3032_ADDR, &device);
+	shimSetBusClock(busHz);
+
+	Trace replayed;
+	uint8_t buffer[RECORD_BUFFER];
+	flushTarget = &replayed;
+	RV3032TraceRecorder recorder(buffer, sizeof(buffer), flushToTrace);
+	rtc.setTraceRecorder(&recorder);
+
+	//Calls start no earlier than they did in the recording
+	RV3032TraceReader reader(old.data(), old.size());
+	RV3032TraceRecord record;
+	uint64_t start = shimMicros64();
+	uint32_t skipped = 0;
+	while (reader.next(record))
+	{
+		if (record.marker == false)
+			continue;
+		if (start + record.time > shimMicros64())
+			shimAdvanceMicros(start + record.time - shimMicros64());
+		recorder.mark(record.tag, micros());
+		if (drive(rtc, record.tag) == false)
+			skipped++;
+	}
+	recorder.flush();
+
+	if (skipped > 0)
+		printf("%lu calls with tags that can't be driven, their transactions are missing from the new trace\n", (unsigned long)skipped);
+	if (device.getMisses() > 0)
+		printf("%lu register reads ran past what the trace recorded, the last value was repeated\n", (unsigned long)device.getMisses());
+
+	TagStats a[TAGS], b[TAGS];
+	summarise(old, a);
+	summarise(replayed, b);
+	printBoth(a, b);
+	firstDifference(old, replayed);
+	if (outPath != NULL && save(outPath, replayed) == false)
+		return 1;
+	return 0;
+}
+
+//A short session against a simulated RV-3032, so there is something to replay without hardware
+static int recordSample(const char * outPath)
+{
+	RV3032Sim sim;
+	Wire.attach(RV3032_ADDR, &sim);
+	shimSetBusClock(busHz);
+	sim.setTime(START_TIME);
+
+	Trace trace;
+	uint8_t buffer[RECORD_BUFFER];
+	flushTarget = &trace;
+	RV3032TraceRecorder recorder(buffer, sizeof(buffer), flushToTrace);
+	RV3032 rtc;
+	rtc.setTraceRecorder(&recorder);
+
+	//The RTC isn't up yet at the first begin(), so the replay has a NACKed probe to answer
+	sim.setResponding(false);
+	recorder.mark(TRACE_TAG_BEGIN, micros());
+	drive(rtc, TRACE_TAG_BEGIN);
+	sim.setResponding(true);
+
+	const uint8_t session[] = {TRACE_TAG_BEGIN, TRACE_TAG_SAVE_CONFIG, TRACE_TAG_CALIBRATION, TRACE_TAG_CLEAR_FLAGS};
+	for (uint8_t i = 0; i < sizeof(session); i++)
+	{
+		recorder.mark(session[i], micros());
+		drive(rtc, session[i]);
+	}
+	for (uint8_t second = 0; second < 10; second++)
+	{
+		shimAdvanceMicros(1000000);
+		recorder.mark(TRACE_TAG_UPDATE_TIME, micros());
+		drive(rtc, TRACE_TAG_UPDATE_TIME);
+		recorder.mark(TRACE_TAG_DRAIN_EVI, micros());
+		drive(rtc, TRACE_TAG_DRAIN_EVI);
+		recorder.mark(TRACE_TAG_TIMESTAMP, micros());
+		drive(rtc, TRACE_TAG_TIMESTAMP);
+	}
+	recorder.flush();
+
+	printf("%lu transactions, %lu bytes\n", (unsigned long)recorder.getTransactions(), (unsigned long)trace.size());
+
+	//Every call the session made must show up, begin() as its address probe
+	TagStats stats[TAGS];
+	summarise(trace, stats);
+	if (stats[TRACE_TAG_BEGIN].transactions != stats[TRACE_TAG_BEGIN].calls)
+	{
+		fprintf(stderr, "begin recorded %lu transactions in %lu calls, expected one address probe each\n",
+			(unsigned long)stats[TRACE_TAG_BEGIN].transactions, (unsigned long)stats[TRACE_TAG_BEGIN].calls);
+		return 1;
+	}
+	for (uint16_t tag = 0; tag < TAGS; tag++)
+	{
+		if (stats[tag].calls > 0 && stats[tag].transactions == 0)
+		{
+			fprintf(stderr, "%s recorded no transactions\n", tagName(tag));
+			return 1;
+		}
+	}
+	return save(outPath, trace) ? 0 : 1;
+}
+
+int main(int argc, char ** argv)
+{
+	const char * paths[2] = {NULL, NULL};
+	uint8_t pathCount = 0;
+	bool driving = false;
+	bool recording = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--bus") == 0 && i + 1 < argc)
+			busHz = strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "--drive") == 0)
+			driving = true;
+		else if (strcmp(argv[i], "--record") == 0)
+			recording = true;
+		else if (pathCount < 2)
+			paths[pathCount++] = argv[i];
+	}
+	if (pathCount == 0 || busHz == 0 || (recording && pathCount != 1))
+	{
+		fprintf(stderr, "usage: rv3032_replay [--bus hz] trace [new] | --drive trace [out] | --record out\n");
+		return 1;
+	}
+
+	if (recording == true)
+		return recordSample(paths[0]);
+
+	Trace traces[2];
+	for (uint8_t i = 0; i < pathCount; i++)
+	{
+		if (driving && i == 1)
+			break;
+		if (load(paths[i], traces[i]) == false)
+			return 1;
+	}
+	if (driving == true)
+		return driveTrace(traces[0], paths[1]);
+
+	TagStats stats[2][TAGS];
+	summarise(traces[0], stats[0]);
+	if (pathCount == 1)
+	{
+		printOne(stats[0]);
+		return 0;
+	}
+	summarise(traces[1], stats[1]);
+	printBoth(stats[0], stats[1]);
+	firstDifference(traces[0], traces[1]);
+	return 0;
+}
@@ -0,0 +1,183 @@
+/******************************************************************************
+rv3032_timebase_sim.cpp
+RV3032 Arduino Library
+
+Feeds simulated CLKOUT edges to RV3032Timebase and RV3032OscillatorCal.
+
+The timebase run clocks a 16 bit counter from a 32768 Hz CLKOUT that is a few ppm off,
+samples it at random intervals just short of the wrap time and checks that the extended
+count never goes backwards and stays within one tick of the edges actually seen.
+
+The calibration run models an RC oscillator with a non linear trim register and jittery
+input captures of a 1024 Hz CLKOUT, then lets suggestTrim() walk the trim until it stops
+moving. A last run gives it a span too short to resolve any error. Exits with 1 if any check
+fails.
+
+  rv3032_timebase_sim [seed]
+
+Build:
+  c++ -O2 -I../../src -o rv3032_timebase_sim rv3032_timebase_sim.cpp ../../src/RV3032_Timebase.cpp
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "RV3032_Timebase.h"
+
+#define CRYSTAL_ERROR_PPM    3.7
+#define TIMEBASE_SAMPLES     200000
+#define COUNTER_WRAP_S       (65536.0 / 32768.0)
+
+#define RC_NOMINAL_HZ        8000000
+#define RC_TRIM_MIN          0
+#define RC_TRIM_MAX          127
+#define RC_TRIM_START        64
+#define RC_PPM_PER_STEP      3500 // What a datasheet would promise, the model below is steeper at the top
+#define CAL_REFERENCE_HZ     1024
+#define CAL_EDGES            1024 // One second of captures per trim step
+#define CAL_JITTER_TICKS     2.0
+#define CAL_MAX_ROUNDS       12
+
+static uint64_t rngState = 88172645463325252ULL;
+
+static double uniform()
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 7;
+	rngState ^= rngState << 17;
+	return (rngState >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static bool timebaseRun()
+{
+	double clockHz = 32768.0 * (1 + CRYSTAL_ERROR_PPM / 1000000);
+	RV3032Timebase timebase(32768, 16);
+
+	double t = 0.37; //The counter is already running when we start looking
+	uint64_t firstEdges = (uint64_t)(t * clockHz);
+	uint64_t previous = timebase.extend(firstEdges & 0xFFFF);
+	double worstUs = 0;
+	bool ok = true;
+
+	for (uint32_t i = 0; i < TIMEBASE_SAMPLES; i++)
+	{
+		t += uniform() * COUNTER_WRAP_S * 0.98;
+		uint64_t edges = (uint64_t)(t * clockHz);
+		uint64_t ticks = timebase.extend(edges & 0xFFFF);
+		if (ticks < previous)
+		{
+			printf("timebase went backwards at sample %u\n", i);
+			ok = false;
+		}
+		if (ticks != edges - firstEdges)
+		{
+			printf("timebase lost edges at sample %u: %llu != %llu\n", i, (unsigned long long)ticks, (unsigned long long)(edges - firstEdges));
+			ok = false;
+			break;
+		}
+		//Against the RTC time scale (edges / 32768) the only error left is the tick quantisation
+		double rtcUs = (t * clockHz - firstEdges) * 1000000.0 / 32768;
+		double errorUs = fabs(rtcUs - (double)timebase.ticksToMicros(ticks));
+		if (errorUs > worstUs)
+			worstUs = errorUs;
+		previous = ticks;
+	}
+
+	//Anchor to 2024-01-01 00:00:00.00 and check a timestamp one hour of ticks later
+	uint64_t anchor = 757382400ULL * 100;
+	timebase.setReference(0, anchor);
+	for (uint32_t i = 1; i <= 3600; i++)
+		timebase.extend((i * 32768) & 0xFFFF);
+	uint64_t stamp = timebase.getTimestampMicros((3600UL * 32768 + 1) & 0xFFFF);
+	uint64_t expected = anchor * 10000 + 3600000000ULL + 30; //One tick is 30.5 us, truncated
+	if (stamp != expected)
+	{
+		printf("timestamp %llu, expected %llu\n", (unsigned long long)stamp, (unsigned long long)expected);
+		ok = false;
+	}
+
+	printf("timebase: %u samples over %.0f s, worst error %.1f us (one tick is %.1f us)\n", TIMEBASE_SAMPLES, t, worstUs, 1000000.0 / 32768);
+	return ok && worstUs <= 1000000.0 / 32768 + 1;
+}
+
+//Frequency of the modelled RC oscillator: 2.7% slow at the start and steeper steps towards the top of the range
+static double rcHz(int16_t trim)
+{
+	double x = trim - RC_TRIM_START;
+	return RC_NOMINAL_HZ * (0.973 + x * 0.0035 + x * fabs(x) * 0.00002);
+}
+
+static bool calibrationRun()
+{
+	double referenceHz = CAL_REFERENCE_HZ * (1 + CRYSTAL_ERROR_PPM / 1000000);
+	RV3032OscillatorCal cal(RC_NOMINAL_HZ, CAL_REFERENCE_HZ);
+	int16_t trim = RC_TRIM_START;
+	double t = 0;
+	uint32_t edges = 0;
+
+	for (uint8_t round = 1; round <= CAL_MAX_ROUNDS; round++)
+	{
+		double mcuHz = rcHz(trim);
+		double mcuStart = uniform() * 4294967296.0; //Start anywhere so the capture counter wraps now and then
+		double tStart = t;
+		cal.reset();
+		for (uint32_t i = 0; i <= CAL_EDGES; i++, edges++)
+		{
+			t = tStart + i / referenceHz;
+			double jitter = (uniform() - 0.5) * 2 * CAL_JITTER_TICKS;
+			uint32_t captured = (uint32_t)fmod(mcuStart + (t - tStart) * mcuHz + jitter + 4294967296.0, 4294967296.0);
+			cal.addCapture(captured, edges);
+		}
+
+		int16_t next = cal.suggestTrim(trim, RC_PPM_PER_STEP, RC_TRIM_MIN, RC_TRIM_MAX);
+		double trueErrorPpm = (mcuHz / RC_NOMINAL_HZ - 1) * 1000000;
+		printf("round %u: trim %3d measured %+7ld ppm (true %+9.1f), next trim %3d\n", round, trim, (long)cal.getErrorPpm(), trueErrorPpm, next);
+		if (labs(cal.getErrorPpm() - lround(trueErrorPpm)) > 5)
+		{
+			printf("measurement off by more than 5 ppm\n");
+			return false;
+		}
+
+		if (next == trim)
+		{
+			//Settled: no neighbouring step may be closer to nominal
+			double here = fabs(rcHz(trim) - RC_NOMINAL_HZ);
+			if (fabs(rcHz(trim - 1) - RC_NOMINAL_HZ) < here || fabs(rcHz(trim + 1) - RC_NOMINAL_HZ) < here)
+			{
+				printf("settled on trim %d but a neighbour is closer\n", trim);
+				return false;
+			}
+			printf("calibration: settled on trim %d after %u rounds, %+.0f ppm left\n", trim, round, trueErrorPpm);
+			return true;
+		}
+		trim = next;
+	}
+	printf("calibration did not settle in %u rounds\n", CAL_MAX_ROUNDS);
+	return false;
+}
+
+//1 Hz nominal over 10 edges: too few expected ticks for a ppm figure, must not divide by zero
+static bool shortSpanRun()
+{
+	RV3032OscillatorCal cal(1, CAL_REFERENCE_HZ);
+	cal.addCapture(0, 0);
+	cal.addCapture(1, 10);
+	bool ok = cal.getErrorPpm() == 0 && cal.suggestTrim(5, 10, -100, 100) == 5;
+	printf("calibration over a short span: %s\n", ok ? "no error reported" : "FAILED");
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1)
+		rngState = strtoull(argv[1], NULL, 0) | 1;
+
+	bool ok = timebaseRun();
+	ok &= calibrationRun();
+	ok &= shortSpanRun();
+	printf(ok ? "PASS\n" : "FAIL\n");
+	return ok ? 0 : 1;
+}
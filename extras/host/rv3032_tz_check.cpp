@@ -0,0 +1,184 @@
+/******************************************************************************
+rv3032_tz_check.cpp
+RV3032 Arduino Library
+
+Compares RV3032TimeZone with the glibc time zone code for a fixed set of POSIX TZ
+rules over 2000-2099: northern and southern hemisphere DST, half hour offsets,
+negative and past midnight transition times, and the Jn, n and Mm.w.d day forms.
+
+utcToLocal(), getOffset() and isDST() are checked every hour and on both sides of
+every transition glibc reports. localToUtc() is checked on the same local times:
+where a local time exists once it must give that UTC time back, where it exists twice
+(end of DST) the DST one, and where it was skipped (start of DST) local minus the
+standard offset. Exits with 1 if any rule doesn't match.
+
+  rv3032_tz_check
+
+Build (Linux, needs glibc):
+  c++ -O2 -I../../src -o rv3032_tz_check rv3032_tz_check.cpp ../../src/RV3032_TimeZone.cpp ../../src/RV3032_Time.cpp
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "RV3032_TimeZone.h"
+
+#define FIRST_UTC        946684800LL // 2000-01-01 00:00:00
+#define END_UTC          4102444800LL // 2100-01-01 00:00:00
+#define STEP             3600
+#define MAX_REPORTS      5
+
+static const char * const rules[] = {
+	"UTC0",
+	"CET-1CEST,M3.5.0,M10.5.0/3",
+	"EST5EDT,M3.2.0,M11.1.0",
+	"PST8PDT,M3.2.0/2:00:00,M11.1.0/2:00:00",
+	"AEST-10AEDT,M10.1.0,M4.1.0/3",
+	"ACST-9:30ACDT,M10.1.0,M4.1.0/3",
+	"NZST-12NZDT,M9.5.0,M4.1.0/3",
+	"IST-5:30",
+	"NPT-5:45",
+	"<-03>3<-02>,M3.5.0/-2,M10.5.0/-1",
+	"<+0330>-3:30",
+	"EST5EDT,M3.2.0/-1,M11.1.0/26",
+	"AAA3BBB,J60/2,J300/2",
+	"AAA-2BBB,59/2,300/2",
+	"AAA4BBB,J1/0,J365/23",
+	"GMT0BST,M3.5.0/1,M10.5.0",
+	"CHAST-12:45CHADT,M9.5.0/2:45,M4.1.0/3:45",
+	"AAA-1BBB-3,M3.5.0,M10.5.0/3",
+};
+
+struct Reference
+{
+	int32_t offset;
+	bool dst;
+};
+
+static Reference reference(time_t utc)
+{
+	struct tm local;
+	localtime_r(&utc, &local);
+	Reference r = {(int32_t)local.tm_gmtoff, local.tm_isdst > 0};
+	return r;
+}
+
+static uint32_t failures = 0;
+static uint32_t skipped = 0; //Local times DST skipped, checked against standard time
+
+static void fail(const char * rule, const char * what, long long utc, long long got, long long expected)
+{
+	if (failures++ < MAX_REPORTS)
+		printf("  %s: %s at %lld, got %lld expected %lld\n", rule, what, utc, got, expected);
+}
+
+static void checkUtc(const char * rule, RV3032TimeZone &zone, time_t utc)
+{
+	Reference r = reference(utc);
+	if (zone.getOffset(utc) != r.offset)
+		fail(rule, "getOffset", utc, zone.getOffset(utc), r.offset);
+	if (zone.utcToLocal(utc) != (uint32_t)(utc + r.offset))
+		fail(rule, "utcToLocal", utc, zone.utcToLocal(utc), utc + r.offset);
+	if (zone.isDST(utc) != r.dst)
+		fail(rule, "isDST", utc, zone.isDST(utc), r.dst);
+}
+
+//Which UTC times glibc shows as local, given the offsets the zone uses
+static void checkLocal(const char * rule, RV3032TimeZone &zone, time_t local, int32_t stdOffset, int32_t dstOffset)
+{
+	if (local < FIRST_UTC || local >= END_UTC)
+		return; //Local times outside 2000-2099 are outside the calendar of the RTC
+	time_t fromStd = local - stdOffset;
+	time_t fromDst = local - dstOffset;
+	bool stdValid = reference(fromStd).offset == stdOffset && reference(fromStd).dst == false;
+	bool dstValid = stdOffset != dstOffset && reference(fromDst).offset == dstOffset && reference(fromDst).dst == true;
+
+	time_t expected = fromStd; //Skipped times, and zones without DST
+	if (dstValid == true)
+		expected = fromDst; //Once in DST, or twice at the end of it
+	else if (stdValid == false)
+		skipped++;
+	if (zone.localToUtc(local) != (uint32_t)expected)
+		fail(rule, "localToUtc", local, zone.localToUtc(local), expected);
+}
+
+static bool checkRule(const char * rule)
+{
+	RV3032TimeZone zone;
+	if (zone.setRule(rule) == false)
+	{
+		printf("  %s: setRule() refused it\n", rule);
+		failures++;
+		return false;
+	}
+	setenv("TZ", rule, 1);
+	tzset();
+
+	//The offsets glibc uses, from the first year
+	int32_t stdOffset = 0, dstOffset = 0;
+	bool dstSeen = false, stdSeen = false;
+	for (time_t t = FIRST_UTC; t < FIRST_UTC + 366 * 86400LL; t += 86400)
+	{
+		Reference r = reference(t);
+		if (r.dst && !dstSeen)
+			dstOffset = r.offset, dstSeen = true;
+		if (!r.dst && !stdSeen)
+			stdOffset = r.offset, stdSeen = true;
+	}
+	if (stdSeen == false)
+		stdOffset = dstOffset - 3600; //DST all year, standard time never shows
+	if (dstSeen == false)
+		dstOffset = stdOffset;
+
+	uint32_t transitions = 0;
+	uint32_t before = failures;
+	skipped = 0;
+	Reference previous = reference(FIRST_UTC);
+	for (time_t t = FIRST_UTC; t < END_UTC; t += STEP)
+	{
+		checkUtc(rule, zone, t);
+		checkLocal(rule, zone, t + stdOffset, stdOffset, dstOffset);
+
+		Reference r = reference(t);
+		if (t > FIRST_UTC && (r.offset != previous.offset || r.dst != previous.dst))
+		{
+			//Find the first second of the new offset, then check both sides of it in UTC and in local time
+			time_t low = t - STEP, high = t;
+			while (high - low > 1)
+			{
+				time_t mid = low + (high - low) / 2;
+				Reference m = reference(mid);
+				if (m.offset == r.offset && m.dst == r.dst)
+					high = mid;
+				else
+					low = mid;
+			}
+			for (time_t s = high - 2; s <= high + 1; s++)
+				checkUtc(rule, zone, s);
+			for (int32_t s = -3601; s <= 3601; s += 600)
+				checkLocal(rule, zone, high + previous.offset + s, stdOffset, dstOffset);
+			for (int32_t s = -1; s <= 1; s++)
+			{
+				checkLocal(rule, zone, high + previous.offset + s, stdOffset, dstOffset);
+				checkLocal(rule, zone, high + r.offset + s, stdOffset, dstOffset);
+			}
+			transitions++;
+		}
+		previous = r;
+	}
+	printf("%-44s %5lu transitions %5lu skipped local times %s\n", rule, (unsigned long)transitions, (unsigned long)skipped,
+		failures == before ? "ok" : "FAILED");
+	return failures == before;
+}
+
+int main()
+{
+	bool ok = true;
+	for (size_t i = 0; i < sizeof(rules) / sizeof(rules[0]); i++)
+		ok &= checkRule(rules[i]);
+	printf(ok ? "PASS\n" : "FAIL\n");
+	return ok ? 0 : 1;
+}
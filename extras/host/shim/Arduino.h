@@ -0,0 +1,38 @@
+/******************************************************************************
+Arduino.h (host shim)
+RV3032 Arduino Library
+
+Just enough of the Arduino API to build the library on a host or a bare MCU toolchain,
+used by the tools in extras/. Build with -DARDUINO=10813 so the library picks
+Arduino.h over WProgram.h. Time comes from a virtual clock that simulations advance
+by hand, or from the host clock once shimUseRealClock() is called.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOW  0
+#define HIGH 1
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+int digitalRead(uint8_t pin);
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+//Shim controls
+void shimUseRealClock(bool real);
+void shimAdvanceMicros(uint64_t us); //Moves the virtual clock
+uint64_t shimMicros64();
+void shimSetPin(uint8_t pin, int level);
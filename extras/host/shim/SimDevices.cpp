@@ -0,0 +1,309 @@
+/******************************************************************************
+SimDevices.cpp (host shim)
+RV3032 Arduino Library
+
+Simulated RV-3032, I2C multiplexer and trace replay target.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "SimDevices.h"
+#include "RV3032_Time.h"
+#include "RV3032_Trace.h"
+
+#define SIM_TIME_LENGTH         8 // Hundredths to year
+#define SIM_STATUS              0x0D
+#define SIM_TEMP_LSB            0x0E
+#define SIM_TEMP_LSB_BSF        0x01
+#define SIM_TEMP_LSB_FLAGS      0x0B // EEF, CLKF and BSF, the rest is read only
+#define SIM_STATUS_PORF         0x02
+#define SIM_TS_CONTROL          0x13
+#define SIM_TS_RESET_BITS       0x38 // EVR, THR and TLR clear themselves
+#define SIM_TS_EVR              0x20
+#define SIM_TS_EVOW             0x04
+#define SIM_STATUS_EVF          0x04
+#define SIM_EVI_COUNT           0x26 // Followed by the 7 capture registers
+#define SIM_CAPTURE_LENGTH      8
+
+RV3032Sim::RV3032Sim( void )
+{
+	memset(_registers, 0, sizeof(_registers));
+	setTime(0);
+}
+
+void RV3032Sim::setTime(uint64_t hundredths)
+{
+	_baseHundredths = hundredths;
+	_baseRemainder = 0;
+	_baseMicros = shimMicros64();
+	latchTime();
+}
+
+//Elapsed shim time scaled by the drift, added to the base
+uint64_t RV3032Sim::getTime()
+{
+	int64_t elapsed = shimMicros64() - _baseMicros;
+	uint64_t micros = _baseRemainder + elapsed + elapsed * _ppm / 1000000;
+	return _baseHundredths + micros / 10000;
+}
+
+void RV3032Sim::setDriftPpm(int32_t ppm)
+{
+	int64_t elapsed = shimMicros64() - _baseMicros;
+	uint64_t micros = _baseRemainder + elapsed + elapsed * _ppm / 1000000;
+	_baseHundredths += micros / 10000;
+	_baseRemainder = micros % 10000;
+	_baseMicros = shimMicros64();
+	_ppm = ppm;
+}
+
+void RV3032Sim::setResponding(bool responding)
+{
+	_responding = responding;
+}
+
+uint8_t &RV3032Sim::registerAt(uint8_t addr)
+{
+	latchTime();
+	return _registers[addr];
+}
+
+uint32_t RV3032Sim::getTransactions()
+{
+	return _transactions;
+}
+
+//The capture keeps the first event after a reset unless EVOW is set
+void RV3032Sim::triggerEvent()
+{
+	latchTime();
+	uint8_t &count = _registers[SIM_EVI_COUNT];
+	if (count == 0 || (_registers[SIM_TS_CONTROL] & SIM_TS_EVOW))
+	{
+		memcpy(&_registers[SIM_EVI_COUNT + 1], _registers, 4); //Hundredths to hours
+		memcpy(&_registers[SIM_EVI_COUNT + 5], _registers + 5, 3); //Date to year, there is no weekday
+	}
+	if (count < 0xFF)
+		count++;
+	_registers[SIM_STATUS] |= SIM_STATUS_EVF;
+}
+
+//The supply drop is the falling edge on EVI, wired as RV3032::enableOutageCapture() expects
+void RV3032Sim::powerOutage(uint64_t micros, bool backupHeld)
+{
+	if (backupHeld == true)
+	{
+		triggerEvent();
+		_registers[SIM_TEMP_LSB] |= SIM_TEMP_LSB_BSF;
+		shimAdvanceMicros(micros);
+		return;
+	}
+	shimAdvanceMicros(micros);
+	memset(_registers, 0, sizeof(_registers));
+	_registers[SIM_STATUS] = SIM_STATUS_PORF;
+	_ppm = 0;
+	setTime(0);
+}
+
+void RV3032Sim::latchTime()
+{
+	rv3032HundredthsToTime(getTime(), _registers);
+}
+
+bool RV3032Sim::write(const uint8_t * data, size_t len)
+{
+	if (_responding == false)
+		return false;
+	_transactions++;
+	if (len == 0)
+		return true;
+
+	_pointer = data[0];
+	bool timeWritten = false;
+	latchTime();
+	for (size_t i = 1; i < len; i++, _pointer++)
+	{
+		if (_pointer == SIM_STATUS)
+			_registers[_pointer] &= data[i]; //Flags are cleared by writing 0, writing 1 leaves them
+		else if (_pointer == SIM_TEMP_LSB)
+			_registers[_pointer] &= data[i] | ~SIM_TEMP_LSB_FLAGS;
+		else if (_pointer == SIM_TS_CONTROL)
+		{
+			if (data[i] & SIM_TS_EVR)
+				memset(&_registers[SIM_EVI_COUNT], 0, SIM_CAPTURE_LENGTH);
+			_registers[_pointer] = data[i] & ~SIM_TS_RESET_BITS;
+		}
+		else if (_pointer != 0) //Hundredths are read only
+			_registers[_pointer] = data[i];
+		if (_pointer < SIM_TIME_LENGTH)
+			timeWritten = true;
+	}
+	if (timeWritten == true)
+	{
+		_registers[0] = 0; //Writing the time clears the hundredths
+		setTime(rv3032TimeToHundredths(_registers));
+	}
+	return true;
+}
+
+//The time registers are latched at the start of the read, like the chip does
+size_t RV3032Sim::read(uint8_t * dest, size_t len)
+{
+	if (_responding == false)
+		return 0;
+	_transactions++;
+	latchTime();
+	for (size_t i = 0; i < len; i++)
+	{
+		dest[i] = _registers[_pointer++];
+	}
+	return len;
+}
+
+I2CMuxSim::I2CMuxSim(TwoWire &bus, uint8_t address)
+{
+	_bus = &bus;
+	memset(_targets, 0, sizeof(_targets));
+	_bus->attach(address, this);
+}
+
+bool I2CMuxSim::attach(uint8_t channel, uint8_t address, I2CDevice * device)
+{
+	if (channel >= SIM_MUX_CHANNELS)
+		return false;
+
+	uint8_t port = 0;
+	while (port < _portCount && _ports[port].address != address)
+		port++;
+	if (port == _portCount)
+	{
+		if (_portCount == SIM_MUX_PORTS)
+			return false;
+		_portCount++;
+		_ports[port].mux = this;
+		_ports[port].address = address;
+		_bus->attach(address, &_ports[port]);
+	}
+	_targets[channel][port] = device;
+	return true;
+}
+
+uint8_t I2CMuxSim::getChannels()
+{
+	return _channels;
+}
+
+uint32_t I2CMuxSim::getWrites()
+{
+	return _writes;
+}
+
+bool I2CMuxSim::write(const uint8_t * data, size_t len)
+{
+	if (len == 0)
+		return true; //Address probe
+	_channels = data[len - 1];
+	_writes++;
+	return true;
+}
+
+size_t I2CMuxSim::read(uint8_t * dest, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+		dest[i] = _channels;
+	return len;
+}
+
+I2CDevice * I2CMuxSim::route(uint8_t address)
+{
+	I2CDevice * target = NULL;
+	for (uint8_t port = 0; port < _portCount; port++)
+	{
+		if (_ports[port].address != address)
+			continue;
+		for (uint8_t channel = 0; channel < SIM_MUX_CHANNELS; channel++)
+		{
+			if ((_channels & (1 << channel)) == 0 || _targets[channel][port] == NULL)
+				continue;
+			if (target != NULL)
+				return NULL; //Two targets answering at once, treat it as a NACK
+			target = _targets[channel][port];
+		}
+	}
+	return target;
+}
+
+bool I2CMuxSim::Port::write(const uint8_t * data, size_t len)
+{
+	I2CDevice * target = mux->route(address);
+	return target != NULL && target->write(data, len);
+}
+
+size_t I2CMuxSim::Port::read(uint8_t * dest, size_t len)
+{
+	I2CDevice * target = mux->route(address);
+	return target != NULL ? target->read(dest, len) : 0;
+}
+
+TraceReplaySim::TraceReplaySim(const uint8_t * trace, size_t len, uint8_t address)
+{
+	memset(_registers, 0, sizeof(_registers));
+	memset(_next, 0, sizeof(_next));
+
+	//Follow the register pointer through the trace and file every byte read under its register
+	RV3032TraceReader reader(trace, len);
+	RV3032TraceRecord record;
+	uint8_t pointer = 0;
+	while (reader.next(record))
+	{
+		if (record.marker == false && record.address == address && record.read == false && record.length == 0)
+			_probes.push_back(record.ack);
+		if (record.marker == true || record.address != address || record.ack == false)
+			continue;
+		if (record.read == false)
+		{
+			if (record.length > 0)
+				pointer = record.data[0] + record.length - 1;
+			continue;
+		}
+		for (uint8_t i = 0; i < record.length; i++, pointer++)
+			_queues[pointer].push_back(record.data[i]);
+	}
+}
+
+uint32_t TraceReplaySim::getTransactions()
+{
+	return _transactions;
+}
+
+uint32_t TraceReplaySim::getMisses()
+{
+	return _misses;
+}
+
+bool TraceReplaySim::write(const uint8_t * data, size_t len)
+{
+	_transactions++;
+	if (len == 0)
+		return _nextProbe < _probes.size() ? _probes[_nextProbe++] : true; //Past the recorded probes the device is there
+	_pointer = data[0];
+	for (size_t i = 1; i < len; i++, _pointer++)
+		_registers[_pointer] = data[i];
+	return true;
+}
+
+size_t TraceReplaySim::read(uint8_t * dest, size_t len)
+{
+	_transactions++;
+	for (size_t i = 0; i < len; i++, _pointer++)
+	{
+		std::vector<uint8_t> &queue = _queues[_pointer];
+		if (_next[_pointer] < queue.size())
+			_registers[_pointer] = queue[_next[_pointer]++];
+		else if (queue.empty() == false)
+			_misses++;
+		dest[i] = _registers[_pointer];
+	}
+	return len;
+}
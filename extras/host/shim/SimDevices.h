@@ -0,0 +1,119 @@
+/******************************************************************************
+SimDevices.h (host shim)
+RV3032 Arduino Library
+
+Simulated I2C targets for the host shim: an RV-3032 whose time runs from the shim clock
+with its own offset and drift, and a TCA9548A style multiplexer that hides the targets
+on its channels until the channel is switched on, and a target that answers with the
+reads of a recorded bus trace (see RV3032_Trace.h).
+
+  RV3032Sim rtc;
+  I2CMuxSim mux(Wire);
+  mux.attach(2, RV3032_ADDR, &rtc);
+  rtc.setTime(hundredthsSince2000);
+  rtc.setDriftPpm(20);
+  rtc.triggerEvent();
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "Wire.h"
+
+#define SIM_MUX_ADDR            0x70
+#define SIM_MUX_CHANNELS        8
+#define SIM_MUX_PORTS           4 // Distinct target addresses behind one mux
+
+class RV3032Sim : public I2CDevice
+{
+public:
+
+	RV3032Sim( void );
+
+	void setTime(uint64_t hundredths); //Hundredths since 2000 at the current shim time
+	uint64_t getTime();
+	void setDriftPpm(int32_t ppm); //Positive runs fast, applies from now on
+	void setResponding(bool responding); //false NACKs every transaction
+	uint8_t &registerAt(uint8_t addr); //Direct access to the register file
+	uint32_t getTransactions();
+	void triggerEvent(); //An edge on EVI: counts it, captures the time if allowed and sets EVF
+	void powerOutage(uint64_t micros, bool backupHeld = true); //Main supply lost for micros: with a backup the supply drop hits EVI and BSF is set, without one the chip resets with PORF
+
+	bool write(const uint8_t * data, size_t len);
+	size_t read(uint8_t * dest, size_t len);
+
+  private:
+	void latchTime();
+
+	uint8_t _registers[256];
+	uint8_t _pointer = 0;
+	uint64_t _baseHundredths = 0;
+	uint64_t _baseMicros = 0;
+	uint64_t _baseRemainder = 0; //Microseconds of the current hundredth at the base
+	int32_t _ppm = 0;
+	bool _responding = true;
+	uint32_t _transactions = 0;
+};
+
+class I2CMuxSim : public I2CDevice
+{
+public:
+
+	I2CMuxSim(TwoWire &bus, uint8_t address = SIM_MUX_ADDR);
+
+	bool attach(uint8_t channel, uint8_t address, I2CDevice * device); //One target per channel and address
+	uint8_t getChannels(); //Channel enable mask last written
+	uint32_t getWrites(); //Writes to the mux itself
+
+	bool write(const uint8_t * data, size_t len);
+	size_t read(uint8_t * dest, size_t len);
+
+  private:
+	//Stands in for every target with one address, and forwards to the one on the enabled channel
+	class Port : public I2CDevice
+	{
+	public:
+		I2CMuxSim * mux = NULL;
+		uint8_t address = 0;
+		bool write(const uint8_t * data, size_t len);
+		size_t read(uint8_t * dest, size_t len);
+	};
+
+	I2CDevice * route(uint8_t address); //NULL if no enabled channel has it, or more than one does
+
+	TwoWire * _bus;
+	uint8_t _channels = 0;
+	uint32_t _writes = 0;
+	Port _ports[SIM_MUX_PORTS];
+	uint8_t _portCount = 0;
+	I2CDevice * _targets[SIM_MUX_CHANNELS][SIM_MUX_PORTS];
+};
+
+//Answers reads with what the device returned in a trace. Every register keeps the queue of
+//values it was read as; each read takes the next one and the last stays once the queue runs
+//out. Writes go to the register file, so values the trace never read back still read right
+class TraceReplaySim : public I2CDevice
+{
+public:
+
+	TraceReplaySim(const uint8_t * trace, size_t len, uint8_t address); //Reads of other addresses are ignored. Address probes ACK or NACK as recorded
+
+	uint32_t getTransactions();
+	uint32_t getMisses(); //Register reads past the end of their queue
+
+	bool write(const uint8_t * data, size_t len);
+	size_t read(uint8_t * dest, size_t len);
+
+  private:
+	uint8_t _registers[256];
+	std::vector<uint8_t> _queues[256];
+	size_t _next[256];
+	std::vector<bool> _probes; //ACK of each recorded address probe, in order
+	size_t _nextProbe = 0;
+	uint8_t _pointer = 0;
+	uint32_t _transactions = 0;
+	uint32_t _misses = 0;
+};
@@ -0,0 +1,57 @@
+/******************************************************************************
+Wire.h (host shim)
+RV3032 Arduino Library
+
+TwoWire that routes transactions to simulated devices attached by address.
+An address without a device NACKs, like an empty bus.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include "Arduino.h"
+
+#define SHIM_WIRE_BUFFER_LENGTH 64
+
+void shimSetBusClock(uint32_t hz); //Each transaction advances the virtual clock by its length on the wire, 0 (default) for none
+
+//A simulated I2C target
+class I2CDevice
+{
+public:
+	virtual ~I2CDevice() {}
+	virtual bool write(const uint8_t * data, size_t len) = 0; //One write transaction, false to NACK
+	virtual size_t read(uint8_t * dest, size_t len) = 0; //One read transaction, returns bytes supplied
+};
+
+class TwoWire
+{
+public:
+
+	TwoWire( void );
+
+	void begin();
+	void beginTransmission(uint8_t address);
+	size_t write(uint8_t value);
+	size_t write(const uint8_t * data, size_t len);
+	uint8_t endTransmission(bool sendStop = true);
+	uint8_t requestFrom(uint8_t address, uint8_t quantity);
+	int available();
+	int read();
+
+	void attach(uint8_t address, I2CDevice * device);
+	void detach(uint8_t address);
+
+  private:
+	I2CDevice * _devices[128];
+	uint8_t _address = 0;
+	uint8_t _tx[SHIM_WIRE_BUFFER_LENGTH];
+	size_t _txLength = 0;
+	uint8_t _rx[SHIM_WIRE_BUFFER_LENGTH];
+	size_t _rxLength = 0;
+	size_t _rxPosition = 0;
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,165 @@
+/******************************************************************************
+shim.cpp (host shim)
+RV3032 Arduino Library
+
+Host implementation of the Arduino.h and Wire.h shims.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include <chrono>
+#include <thread>
+
+static bool realClock = false;
+static uint64_t virtualMicros = 0;
+static int pins[256];
+
+void shimUseRealClock(bool real)
+{
+	realClock = real;
+}
+
+void shimAdvanceMicros(uint64_t us)
+{
+	virtualMicros += us;
+}
+
+uint64_t shimMicros64()
+{
+	if (realClock)
+	{
+		static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+	return virtualMicros;
+}
+
+unsigned long millis()
+{
+	return shimMicros64() / 1000;
+}
+
+unsigned long micros()
+{
+	return shimMicros64();
+}
+
+void delay(unsigned long ms)
+{
+	delayMicroseconds(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	if (realClock)
+		std::this_thread::sleep_for(std::chrono::microseconds(us));
+	else
+		virtualMicros += us;
+}
+
+void shimSetPin(uint8_t pin, int level)
+{
+	pins[pin] = level;
+}
+
+int digitalRead(uint8_t pin)
+{
+	if (!realClock)
+		virtualMicros++; //Polling loops must see time move
+	return pins[pin];
+}
+
+TwoWire Wire;
+static uint32_t busClock = 0;
+
+void shimSetBusClock(uint32_t hz)
+{
+	busClock = hz;
+}
+
+//Start, address and stop plus nine bits per byte
+static void busTime(size_t bytes)
+{
+	if (busClock != 0 && !realClock)
+		virtualMicros += ((uint64_t)(11 + 9 * bytes) * 1000000 + busClock - 1) / busClock;
+}
+
+TwoWire::TwoWire( void )
+{
+	memset(_devices, 0, sizeof(_devices));
+}
+
+void TwoWire::begin()
+{
+}
+
+void TwoWire::attach(uint8_t address, I2CDevice * device)
+{
+	_devices[address & 0x7F] = device;
+}
+
+void TwoWire::detach(uint8_t address)
+{
+	_devices[address & 0x7F] = NULL;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+	_address = address & 0x7F;
+	_txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t value)
+{
+	if (_txLength == SHIM_WIRE_BUFFER_LENGTH)
+		return 0;
+	_tx[_txLength++] = value;
+	return 1;
+}
+
+size_t TwoWire::write(const uint8_t * data, size_t len)
+{
+	size_t written = 0;
+	while (written < len && write(data[written]))
+		written++;
+	return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+	(void)sendStop;
+	busTime(_txLength);
+	I2CDevice * device = _devices[_address];
+	if (device == NULL)
+		return 2; //Address NACK
+	return device->write(_tx, _txLength) ? 0 : 3; //Data NACK
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity)
+{
+	_rxLength = 0;
+	_rxPosition = 0;
+	I2CDevice * device = _devices[address & 0x7F];
+	if (device == NULL)
+		return 0;
+	if (quantity > SHIM_WIRE_BUFFER_LENGTH)
+		quantity = SHIM_WIRE_BUFFER_LENGTH;
+	_rxLength = device->read(_rx, quantity);
+	busTime(quantity); //After the read, the device sees the start of the transfer
+	return _rxLength;
+}
+
+int TwoWire::available()
+{
+	return _rxLength - _rxPosition;
+}
+
+int TwoWire::read()
+{
+	if (_rxPosition == _rxLength)
+		return -1;
+	return _rx[_rxPosition++];
+}
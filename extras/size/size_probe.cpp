@@ -0,0 +1,54 @@
+/******************************************************************************
+size_probe.cpp
+RV3032 Arduino Library
+
+Representative sketch for size_report.sh. It calls whatever the enabled feature
+gates leave in the library, so with --gc-sections the image holds exactly the
+code a sketch of that configuration pays for.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include <SparkFun_RV3032.h>
+
+RV3032 rtc;
+volatile uint32_t sink;
+
+int main()
+{
+	rtc.begin();
+	if (rtc.updateTime() == false)
+		return 1;
+	sink = rtc.getSeconds();
+
+#if RV3032_ENABLE_EPOCH
+	sink = rtc.getEpoch();
+#endif
+
+#if RV3032_ENABLE_FORMATTING
+	sink = (uintptr_t)rtc.stringTime8601();
+	sink = (uintptr_t)rtc.stringTime();
+#endif
+
+#if RV3032_ENABLE_EEPROM
+	rtc.setCalibrationOffsetSteps(3);
+#if RV3032_ENABLE_FLOAT
+	sink = rtc.getCalibrationOffset() * 1000;
+#endif
+#endif
+
+#if RV3032_ENABLE_INTERRUPTS
+	rtc.enableHardwareInterrupt(CONTROL2_AIE);
+	rtc.setAlarmMinutes(30);
+	sink = rtc.getInterruptFlag(STATUS_AF);
+#endif
+
+#if RV3032_ENABLE_EVI
+	RV3032EventBuffer events;
+	rtc.setEVIEventCapture(true);
+	sink = rtc.drainEVIEvents(events);
+#endif
+
+	return 0;
+}
@@ -0,0 +1,89 @@
+#!/bin/sh
+#
+# size_report.sh
+# RV3032 Arduino Library
+#
+# Builds size_probe.cpp in each feature gate configuration with every toolchain
+# found on the PATH and compares text/data/bss against size_baseline.txt.
+# Exits non-zero if a configuration grew by more than RV3032_SIZE_SLACK bytes
+# (default 16) of flash or RAM.
+#
+#   extras/size/size_report.sh            compare against the baseline
+#   extras/size/size_report.sh --update   rewrite the baseline entries for the toolchains found
+#
+# Baseline lines are "toolchain version config text data bss". Entries only
+# compare when the compiler version matches, because code size moves between
+# releases. The committed baseline only has host g++ rows: avr-g++ and
+# arm-none-eabi-g++ were not installed where it was made, so the AVR and
+# Cortex-M0+ rows are skipped until someone runs --update with them. Host sizes
+# track growth but are not what a sketch costs on a board.
+#
+# Everything builds with -Wall -Wextra and the warnings are shown.
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+BASELINE="$HERE/size_baseline.txt"
+SLACK=${RV3032_SIZE_SLACK:-16}
+UPDATE=0
+[ "$1" = "--update" ] && UPDATE=1
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+SOURCES="$HERE/size_probe.cpp $HERE/size_stubs.cpp $ROOT/src/SparkFun_RV3032.cpp $ROOT/src/SparkFun_RV8803.cpp $ROOT/src/RV_ClockCore.cpp $ROOT/src/RV3032_Time.cpp $ROOT/src/RV3032_TimeZone.cpp $ROOT/src/RV3032_Timebase.cpp $ROOT/src/RV3032_Power.cpp $ROOT/src/RV3032_Mux.cpp $ROOT/src/RV3032_Trace.cpp $ROOT/src/RV3032_Latency.cpp"
+COMMON="-std=gnu++11 -Os -Wall -Wextra -DARDUINO=10813 -ffunction-sections -fdata-sections -I$ROOT/src -I$ROOT/extras/host/shim"
+
+# name|gate defines
+CONFIGS="minimal|-DRV3032_ENABLE_FORMATTING=0 -DRV3032_ENABLE_EEPROM=0 -DRV3032_ENABLE_FLOAT=0 -DRV3032_ENABLE_INTERRUPTS=0 -DRV3032_ENABLE_EVI=0 -DRV3032_ENABLE_ENERGY=0 -DRV3032_ENABLE_TRACE=0
+integer|-DRV3032_ENABLE_FLOAT=0
+full|"
+
+# name|compiler|size tool|flags
+TOOLCHAINS="avr|avr-g++|avr-size|-mmcu=atmega328p -fno-exceptions -fno-threadsafe-statics
+cortex-m0|arm-none-eabi-g++|arm-none-eabi-size|-mcpu=cortex-m0plus -mthumb -fno-exceptions -fno-rtti --specs=nano.specs --specs=nosys.specs
+host|g++|size|"
+
+STATUS=0
+NEW="$WORK/baseline"
+[ -f "$BASELINE" ] && cp "$BASELINE" "$NEW" || : > "$NEW"
+
+printf '%-10s %-8s %8s %8s %8s   %s\n' toolchain config text data bss "change (text/data/bss)"
+
+echo "$TOOLCHAINS" | while IFS='|' read -r TOOL CXX SIZE FLAGS; do
+	if ! command -v "$CXX" >/dev/null 2>&1; then
+		echo "$TOOL: $CXX not found, skipped"
+		continue
+	fi
+	VERSION=$($CXX -dumpversion)
+	echo "$CONFIGS" | while IFS='|' read -r CONFIG GATES; do
+		ELF="$WORK/$TOOL-$CONFIG.elf"
+		$CXX $COMMON $FLAGS $GATES $SOURCES -Wl,--gc-sections -o "$ELF"
+		set -- $($SIZE "$ELF" | tail -n 1)
+		TEXT=$1 DATA=$2 BSS=$3
+		OLD=$(awk -v t="$TOOL" -v v="$VERSION" -v c="$CONFIG" '$1==t && $2==v && $3==c { print $4, $5, $6 }' "$NEW")
+		CHANGE="new"
+		if [ -n "$OLD" ]; then
+			set -- $OLD
+			CHANGE="$((TEXT - $1))/$((DATA - $2))/$((BSS - $3))"
+			if [ $UPDATE -eq 0 ] && { [ $((TEXT - $1)) -gt "$SLACK" ] || [ $((DATA + BSS - $2 - $3)) -gt "$SLACK" ]; }; then
+				CHANGE="$CHANGE  REGRESSION"
+				touch "$WORK/failed"
+			fi
+		fi
+		printf '%-10s %-8s %8s %8s %8s   %s\n' "$TOOL" "$CONFIG" "$TEXT" "$DATA" "$BSS" "$CHANGE"
+		awk -v t="$TOOL" -v c="$CONFIG" '!($1==t && $3==c)' "$NEW" > "$NEW.tmp"
+		echo "$TOOL $VERSION $CONFIG $TEXT $DATA $BSS" >> "$NEW.tmp"
+		mv "$NEW.tmp" "$NEW"
+	done
+done
+
+if [ $UPDATE -eq 1 ]; then
+	sort "$NEW" > "$BASELINE"
+	echo "Baseline written to $BASELINE"
+elif [ -f "$WORK/failed" ]; then
+	echo "Size regression beyond $SLACK bytes, run with --update if it is intended"
+	STATUS=1
+fi
+exit $STATUS
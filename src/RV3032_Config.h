@@ -0,0 +1,223 @@
+/******************************************************************************
+RV3032_Config.h
+RV3032 Arduino Library
+
+Compile time RTC configuration. Build a profile once with chained calls and the
+register image is computed by the compiler, then RV3032::begin(config) applies it
+with one burst write instead of a string of read-modify-write setters:
+
+  RV3032_CONFIG(rtcConfig, RV3032Config()
+    .timer(COUNTDOWN_TIMER_FREQUENCY_1_HZ, 60)
+    .eviEdge(RISING_EDGE)
+    .eviDebounce(EVI_DEBOUNCE_256HZ)
+    .interrupts((1 << CONTROL2_TIE) | (1 << CONTROL2_EIE)));
+
+RV3032_CONFIG declares the constant and static_asserts that the combination is valid.
+Everything is C++11 constexpr so it works with the Arduino AVR toolchain.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+//Slots of the register image. 0-13 map to registers 0x08-0x15, the rest to EEPROM mirror bits this config owns
+#define CONFIG_SLOT_ALARM_MINUTES          0
+#define CONFIG_SLOT_ALARM_HOURS            1
+#define CONFIG_SLOT_ALARM_DATE             2
+#define CONFIG_SLOT_TIMER_0                3
+#define CONFIG_SLOT_TIMER_1                4
+#define CONFIG_SLOT_CONTROL1               8
+#define CONFIG_SLOT_CONTROL2               9
+#define CONFIG_SLOT_CONTROL3               10
+#define CONFIG_SLOT_TS_CONTROL             11
+#define CONFIG_SLOT_CLOCK_INT_MASK         12
+#define CONFIG_SLOT_EVI_CONTROL            13
+#define CONFIG_SLOT_PMU                    14
+#define CONFIG_SLOT_PMU_MASK               15
+#define CONFIG_SLOT_CLKOUT2                16
+#define CONFIG_SLOT_CLKOUT2_MASK           17
+#define CONFIG_SLOTS                       18
+
+#define CONFIG_INTERRUPT_BITS              0x7C // CLKIE, UIE, TIE, AIE and EIE in Control 2
+
+enum rv3032_config_error {
+	CONFIG_OK,
+	CONFIG_ERROR_ALARM_RANGE,
+	CONFIG_ERROR_TIMER_FREQUENCY,
+	CONFIG_ERROR_TIMER_TICKS, //Ticks must be 1-4095
+	CONFIG_ERROR_EVI_DEBOUNCE,
+	CONFIG_ERROR_CLKOUT_FREQUENCY,
+	CONFIG_ERROR_INTERRUPT_MASK, //Only Control 2 interrupt enable bits are allowed
+	CONFIG_ERROR_TIMER_INTERRUPT, //Timer interrupt enabled without a running timer
+	CONFIG_ERROR_ALARM_INTERRUPT, //Alarm interrupt enabled without any alarm field to match
+};
+
+class RV3032Config
+{
+public:
+
+	//Reset state of the RTC with every alarm match disabled
+	constexpr RV3032Config( void )
+		: _reg{0x80, 0x80, 0x80, 0, 0, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, _twelveHour(true), _error(CONFIG_OK)
+	{
+	}
+
+	constexpr RV3032Config twelveHour(bool enable) const
+	{
+		return RV3032Config(*this, enable, _error);
+	}
+
+	//Each call adds one field to match, the alarm fires when all matched fields agree
+	constexpr RV3032Config alarmMinutes(uint8_t minute) const
+	{
+		return minute > 59 ? fail(CONFIG_ERROR_ALARM_RANGE) : set(CONFIG_SLOT_ALARM_MINUTES, 0xFF, bcd(minute));
+	}
+
+	constexpr RV3032Config alarmHours(uint8_t hour) const
+	{
+		return hour > 23 ? fail(CONFIG_ERROR_ALARM_RANGE) : set(CONFIG_SLOT_ALARM_HOURS, 0xFF, bcd(hour));
+	}
+
+	constexpr RV3032Config alarmDate(uint8_t date) const
+	{
+		return (date < 1 || date > 31) ? fail(CONFIG_ERROR_ALARM_RANGE) : set(CONFIG_SLOT_ALARM_DATE, 0xFF, bcd(date));
+	}
+
+	//Enables the countdown timer with one of the COUNTDOWN_TIMER_FREQUENCY settings and 1-4095 ticks
+	constexpr RV3032Config timer(uint8_t frequency, uint16_t ticks) const
+	{
+		return frequency > 3 ? fail(CONFIG_ERROR_TIMER_FREQUENCY)
+			: (ticks < 1 || ticks > 4095) ? fail(CONFIG_ERROR_TIMER_TICKS)
+			: set(CONFIG_SLOT_TIMER_0, 0xFF, ticks & 0xFF)
+				.set(CONFIG_SLOT_TIMER_1, 0x0F, ticks >> 8)
+				.set(CONFIG_SLOT_CONTROL1, 0x0B, (1 << 3) | frequency); //TE and TD
+	}
+
+	constexpr RV3032Config periodicUpdate(bool everyMinute) const
+	{
+		return set(CONFIG_SLOT_CONTROL1, 1 << 4, everyMinute << 4); //USEL
+	}
+
+	constexpr RV3032Config eviEdge(bool rising) const
+	{
+		return set(CONFIG_SLOT_EVI_CONTROL, 1 << 6, rising << 6); //EHL
+	}
+
+	constexpr RV3032Config eviDebounce(uint8_t debounce) const
+	{
+		return debounce > 3 ? fail(CONFIG_ERROR_EVI_DEBOUNCE) : set(CONFIG_SLOT_EVI_CONTROL, 3 << 4, debounce << 4); //ET
+	}
+
+	constexpr RV3032Config eviCapture(bool lastEvent) const
+	{
+		return set(CONFIG_SLOT_TS_CONTROL, 1 << 2, lastEvent << 2); //EVOW
+	}
+
+	//Drives CLKOUT with one of the CLKOUT_FREQUENCY settings. FD and NCLKE are only written to the RAM
+	//mirror of the EEPROM, so both CLKOUT calls also set EERD to keep the daily refresh from undoing them
+	constexpr RV3032Config clockOut(uint8_t frequency) const
+	{
+		return frequency > 3 ? fail(CONFIG_ERROR_CLKOUT_FREQUENCY)
+			: set(CONFIG_SLOT_CLKOUT2, 3 << 5, frequency << 5).set(CONFIG_SLOT_PMU, 1 << 6, 0).refreshDisabled(); //FD, NCLKE cleared
+	}
+
+	constexpr RV3032Config clockOutDisabled() const
+	{
+		return set(CONFIG_SLOT_PMU, 1 << 6, 1 << 6).refreshDisabled(); //NCLKE
+	}
+
+	//Control 2 interrupt enables, e.g. (1 << CONTROL2_AIE) | (1 << CONTROL2_EIE)
+	constexpr RV3032Config interrupts(uint8_t control2Bits) const
+	{
+		return (control2Bits & ~CONFIG_INTERRUPT_BITS) ? fail(CONFIG_ERROR_INTERRUPT_MASK) : set(CONFIG_SLOT_CONTROL2, CONFIG_INTERRUPT_BITS, control2Bits);
+	}
+
+	//First problem found, range errors from the builder calls before cross checks
+	constexpr uint8_t error() const
+	{
+		return _error != CONFIG_OK ? _error
+			: ((_reg[CONFIG_SLOT_CONTROL2] & (1 << 4)) && !(_reg[CONFIG_SLOT_CONTROL1] & (1 << 3))) ? (uint8_t)CONFIG_ERROR_TIMER_INTERRUPT
+			: ((_reg[CONFIG_SLOT_CONTROL2] & (1 << 3)) && (_reg[CONFIG_SLOT_ALARM_MINUTES] & _reg[CONFIG_SLOT_ALARM_HOURS] & _reg[CONFIG_SLOT_ALARM_DATE] & 0x80)) ? (uint8_t)CONFIG_ERROR_ALARM_INTERRUPT
+			: (uint8_t)CONFIG_OK;
+	}
+
+	constexpr bool isValid() const
+	{
+		return error() == CONFIG_OK;
+	}
+
+	constexpr uint8_t getRegister(uint8_t slot) const
+	{
+		return _reg[slot];
+	}
+
+	constexpr bool getTwelveHour() const
+	{
+		return _twelveHour;
+	}
+
+  private:
+	uint8_t _reg[CONFIG_SLOTS];
+	bool _twelveHour;
+	uint8_t _error;
+
+	constexpr RV3032Config(const RV3032Config &base, bool twelveHour, uint8_t error)
+		: _reg{base._reg[0], base._reg[1], base._reg[2], base._reg[3], base._reg[4], base._reg[5], base._reg[6], base._reg[7], base._reg[8],
+			base._reg[9], base._reg[10], base._reg[11], base._reg[12], base._reg[13], base._reg[14], base._reg[15], base._reg[16], base._reg[17]},
+		_twelveHour(twelveHour), _error(error)
+	{
+	}
+
+	constexpr RV3032Config(const RV3032Config &base, uint8_t slot, uint8_t mask, uint8_t value)
+		: _reg{base.merge(0, slot, mask, value), base.merge(1, slot, mask, value), base.merge(2, slot, mask, value), base.merge(3, slot, mask, value),
+			base.merge(4, slot, mask, value), base.merge(5, slot, mask, value), base.merge(6, slot, mask, value), base.merge(7, slot, mask, value),
+			base.merge(8, slot, mask, value), base.merge(9, slot, mask, value), base.merge(10, slot, mask, value), base.merge(11, slot, mask, value),
+			base.merge(12, slot, mask, value), base.merge(13, slot, mask, value), base.merge(14, slot, mask, value), base.merge(15, slot, mask, value),
+			base.merge(16, slot, mask, value), base.merge(17, slot, mask, value)},
+		_twelveHour(base._twelveHour), _error(base._error)
+	{
+	}
+
+	//New value of slot n after writing value under mask to slot. EEPROM slots also record the mask in the slot after them
+	constexpr uint8_t merge(uint8_t n, uint8_t slot, uint8_t mask, uint8_t value) const
+	{
+		return n == slot ? (uint8_t)((_reg[n] & ~mask) | (value & mask))
+			: (slot >= CONFIG_SLOT_PMU && n == slot + 1) ? (uint8_t)(_reg[n] | mask)
+			: _reg[n];
+	}
+
+	constexpr RV3032Config set(uint8_t slot, uint8_t mask, uint8_t value) const
+	{
+		return RV3032Config(*this, slot, mask, value);
+	}
+
+	constexpr RV3032Config refreshDisabled() const
+	{
+		return set(CONFIG_SLOT_CONTROL1, 1 << 2, 1 << 2); //EERD
+	}
+
+	constexpr RV3032Config fail(uint8_t error) const
+	{
+		return RV3032Config(*this, _twelveHour, _error != CONFIG_OK ? _error : error);
+	}
+
+	static constexpr uint8_t bcd(uint8_t val)
+	{
+		return ( ( val / 10 ) * 0x10 ) + ( val % 10 );
+	}
+};
+
+//Declares a constexpr RV3032Config and rejects invalid combinations at compile time
+#define RV3032_CONFIG(name, builder) \
+	constexpr RV3032Config name = builder; \
+	static_assert(name.error() != CONFIG_ERROR_ALARM_RANGE, "RV3032Config: alarm minute, hour or date out of range"); \
+	static_assert(name.error() != CONFIG_ERROR_TIMER_FREQUENCY, "RV3032Config: timer frequency must be a COUNTDOWN_TIMER_FREQUENCY setting"); \
+	static_assert(name.error() != CONFIG_ERROR_TIMER_TICKS, "RV3032Config: timer ticks must be 1-4095"); \
+	static_assert(name.error() != CONFIG_ERROR_EVI_DEBOUNCE, "RV3032Config: EVI debounce must be an EVI_DEBOUNCE setting"); \
+	static_assert(name.error() != CONFIG_ERROR_CLKOUT_FREQUENCY, "RV3032Config: CLKOUT frequency must be a CLKOUT_FREQUENCY setting"); \
+	static_assert(name.error() != CONFIG_ERROR_INTERRUPT_MASK, "RV3032Config: only Control 2 interrupt enable bits can be set"); \
+	static_assert(name.error() != CONFIG_ERROR_TIMER_INTERRUPT, "RV3032Config: timer interrupt enabled without a timer"); \
+	static_assert(name.error() != CONFIG_ERROR_ALARM_INTERRUPT, "RV3032Config: alarm interrupt enabled without an alarm field to match")
@@ -0,0 +1,325 @@
+/******************************************************************************
+RV3032_Latency.cpp
+RV3032 Arduino Library
+
+Interrupt latency profiling with the EVI timestamp.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "RV3032_Latency.h"
+
+RV3032ClockMap::RV3032ClockMap( void )
+{
+	reset();
+}
+
+void RV3032ClockMap::reset()
+{
+	_count = 0;
+	_lastMicros = 0;
+}
+
+void RV3032ClockMap::addPoint(uint64_t hundredths, uint32_t mcuMicros)
+{
+	uint64_t extended = mcuMicros;
+	if (_count > 0)
+		extended = _micros[_count - 1] + (uint32_t)(mcuMicros - _lastMicros);
+	_lastMicros = mcuMicros;
+
+	if (_count == RV3032_LATENCY_SYNC_POINTS)
+	{
+		for (uint8_t i = 1; i < _count; i++)
+		{
+			_hundredths[i - 1] = _hundredths[i];
+			_micros[i - 1] = _micros[i];
+		}
+		_count--;
+	}
+	_hundredths[_count] = hundredths;
+	_micros[_count] = extended;
+	_count++;
+}
+
+uint8_t RV3032ClockMap::getPoints()
+{
+	return _count;
+}
+
+bool RV3032ClockMap::toMicros(uint64_t hundredths, uint32_t &mcuMicros)
+{
+	if (_count == 0)
+		return false;
+
+	int64_t offset;
+	if (_count == 1)
+	{
+		offset = ((int64_t)hundredths - (int64_t)_hundredths[0]) * RV3032_LATENCY_TICK_MICROS;
+		mcuMicros = (uint32_t)(_micros[0] + offset);
+		return true;
+	}
+
+	//The segment that holds the time, or the first or last one past the ends
+	uint8_t i = 0;
+	while (i + 2 < _count && hundredths >= _hundredths[i + 1])
+		i++;
+	int64_t span = (int64_t)(_hundredths[i + 1] - _hundredths[i]);
+	int64_t spanMicros = (int64_t)(_micros[i + 1] - _micros[i]);
+	if (span <= 0)
+		return false;
+	offset = ((int64_t)hundredths - (int64_t)_hundredths[i]) * spanMicros / span;
+	mcuMicros = (uint32_t)(_micros[i] + offset);
+	return true;
+}
+
+int32_t RV3032ClockMap::getDriftPpm()
+{
+	if (_count < 2)
+		return 0;
+	int64_t rtcMicros = (int64_t)(_hundredths[_count - 1] - _hundredths[0]) * RV3032_LATENCY_TICK_MICROS;
+	int64_t mcuMicros = (int64_t)(_micros[_count - 1] - _micros[0]);
+	if (rtcMicros <= 0)
+		return 0;
+	return (int32_t)((mcuMicros - rtcMicros) * 1000000 / rtcMicros);
+}
+
+RV3032LatencyHistogram::RV3032LatencyHistogram(int32_t firstMicros, uint32_t binMicros)
+{
+	_first = firstMicros;
+	_width = binMicros ? binMicros : 1;
+	reset();
+}
+
+void RV3032LatencyHistogram::reset()
+{
+	memset(_bins, 0, sizeof(_bins));
+	_underflow = 0;
+	_overflow = 0;
+	_count = 0;
+	_sum = 0;
+	_min = 0;
+	_max = 0;
+}
+
+void RV3032LatencyHistogram::add(int32_t latencyMicros)
+{
+	if (_count == 0 || latencyMicros < _min)
+		_min = latencyMicros;
+	if (_count == 0 || latencyMicros > _max)
+		_max = latencyMicros;
+	_count++;
+	_sum += latencyMicros;
+
+	if (latencyMicros < _first)
+	{
+		_underflow++;
+		return;
+	}
+	uint32_t bin = (uint32_t)((int64_t)latencyMicros - _first) / _width;
+	if (bin >= RV3032_LATENCY_BINS)
+		_overflow++;
+	else
+		_bins[bin]++;
+}
+
+uint32_t RV3032LatencyHistogram::getCount()
+{
+	return _count;
+}
+
+uint8_t RV3032LatencyHistogram::getBins()
+{
+	return RV3032_LATENCY_BINS;
+}
+
+uint32_t RV3032LatencyHistogram::getBin(uint8_t bin)
+{
+	return bin < RV3032_LATENCY_BINS ? _bins[bin] : 0;
+}
+
+int32_t RV3032LatencyHistogram::getBinStart(uint8_t bin)
+{
+	return _first + (int32_t)(bin * _width);
+}
+
+uint32_t RV3032LatencyHistogram::getUnderflow()
+{
+	return _underflow;
+}
+
+uint32_t RV3032LatencyHistogram::getOverflow()
+{
+	return _overflow;
+}
+
+int32_t RV3032LatencyHistogram::getMin()
+{
+	return _min;
+}
+
+int32_t RV3032LatencyHistogram::getMax()
+{
+	return _max;
+}
+
+int32_t RV3032LatencyHistogram::getMean()
+{
+	if (_count == 0)
+		return 0;
+	int64_t half = _sum < 0 ? -(int64_t)(_count / 2) : (int64_t)(_count / 2);
+	return (int32_t)((_sum + half) / (int64_t)_count);
+}
+
+int32_t RV3032LatencyHistogram::getPercentile(uint8_t percent)
+{
+	if (_count == 0)
+		return 0;
+	if (percent > 100)
+		percent = 100;
+	uint32_t target = ((uint64_t)_count * percent + 99) / 100; //The target'th smallest latency
+	if (target == 0)
+		target = 1;
+
+	uint32_t seen = _underflow;
+	if (seen >= target)
+		return _min;
+	for (uint8_t bin = 0; bin < RV3032_LATENCY_BINS; bin++)
+	{
+		seen += _bins[bin];
+		if (seen >= target)
+			return getBinStart(bin + 1);
+	}
+	return _max;
+}
+
+#if RV3032_ENABLE_EVI
+RV3032LatencyProfiler::RV3032LatencyProfiler(RV3032 &rtc, RV3032LatencyHistogram &histogram)
+{
+	_rtc = &rtc;
+	_histogram = &histogram;
+}
+
+bool RV3032LatencyProfiler::begin()
+{
+	_map.reset();
+	_captures.clear();
+	_pending = false;
+	_events = 0;
+	_missed = 0;
+
+	//The first event after each drain keeps its timestamp, which is the one the handler time belongs to
+	if (_rtc->setTSOverwrite(EVI_CAPTURE_FIRST_EVENT) == false || _rtc->setEVIEventCapture(EVI_CAPTURE_ENABLE) == false)
+		return false;
+	return sync();
+}
+
+//Where a read landed in MCU time: the RTC latches the time at the start of the read, halfway through the call
+static bool readHundredths(RV3032 *rtc, uint8_t &hundredths, uint32_t &readMicros)
+{
+	uint32_t before = micros();
+	if (rtc->readMultipleRegisters(RV3032_HUNDREDTHS, &hundredths, 1) == false)
+		return false;
+	readMicros = before + (uint32_t)(micros() - before) / 2;
+	return true;
+}
+
+/*********************************
+Polls the hundredths register until it changes. The tick happened between the last two reads, so
+the point is set halfway between them: with one byte reads at 100 kHz that is within 0.3 ms.
+The whole time is read afterwards and wound back to the tick.
+*********************************/
+bool RV3032LatencyProfiler::sync()
+{
+	uint8_t previous;
+	uint32_t previousMicros;
+	if (readHundredths(_rtc, previous, previousMicros) == false)
+		return false;
+	uint32_t start = previousMicros;
+
+	while ((uint32_t)(previousMicros - start) < RV3032_LATENCY_SYNC_TIMEOUT_MS * 1000UL)
+	{
+		uint8_t hundredths;
+		uint32_t readMicros;
+		if (readHundredths(_rtc, hundredths, readMicros) == false)
+			return false;
+		if (hundredths == previous)
+		{
+			previousMicros = readMicros;
+			continue;
+		}
+
+		uint32_t tickMicros = previousMicros + (readMicros - previousMicros) / 2;
+		uint8_t time[TIME_ARRAY_LENGTH];
+		if (_rtc->readMultipleRegisters(RV3032_HUNDREDTHS, time, TIME_ARRAY_LENGTH) == false)
+			return false;
+		uint8_t since = (rv3032BCDtoDEC(time[TIME_HUNDREDTHS]) + 100 - rv3032BCDtoDEC(hundredths)) % 100;
+		_map.addPoint(rv3032TimeToHundredths(time) - since, tickMicros);
+		_lastSync = micros();
+		return true;
+	}
+	return false; //Error: the RTC isn't counting
+}
+
+void RV3032LatencyProfiler::handlerRan()
+{
+	uint32_t now = micros();
+	if (_pending == true)
+		return; //Its capture was not kept either, update() counts it as missed
+	_handlerMicros = now;
+	_pending = true;
+}
+
+bool RV3032LatencyProfiler::update()
+{
+	if (_pending == false)
+	{
+		if ((uint32_t)(micros() - _lastSync) >= RV3032_LATENCY_SYNC_INTERVAL_MS * 1000UL)
+			sync();
+		return false;
+	}
+
+	uint8_t count = _rtc->drainEVIEvents(_captures);
+	noInterrupts();
+	uint32_t handlerMicros = _handlerMicros;
+	_pending = false;
+	interrupts();
+
+	RV3032Event event;
+	if (count == 0 || _captures.pop(event) == false)
+	{
+		_missed++;
+		return false; //The MCU saw an event the RTC didn't
+	}
+	_missed += count - 1; //Only the first capture is kept
+
+	uint64_t hundredths = (((uint64_t)rv3032DaysSince2000(event.year, event.month, event.date) * 24 + event.hours) * 3600
+		+ event.minutes * 60 + event.seconds) * 100 + event.hundredths;
+	uint32_t eventMicros;
+	if (_map.toMicros(hundredths, eventMicros) == false)
+	{
+		_missed++;
+		return false;
+	}
+
+	//From the middle of the hundredth the event fell in
+	_histogram->add((int32_t)(handlerMicros - eventMicros) - RV3032_LATENCY_TICK_MICROS / 2);
+	_events++;
+	return true;
+}
+
+uint32_t RV3032LatencyProfiler::getEvents()
+{
+	return _events;
+}
+
+uint32_t RV3032LatencyProfiler::getMissed()
+{
+	return _missed;
+}
+
+RV3032ClockMap &RV3032LatencyProfiler::getClockMap()
+{
+	return _map;
+}
+#endif
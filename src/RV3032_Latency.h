@@ -0,0 +1,126 @@
+/******************************************************************************
+RV3032_Latency.h
+RV3032 Arduino Library
+
+Interrupt latency profiling with the EVI timestamp. Wire the event to EVI and to an
+interrupt pin of the MCU. The RTC captures the time of the edge to the hundredth of a
+second, the handler stores micros() with handlerRan(), and update() turns the capture
+into MCU time and adds handler - event to a histogram.
+
+RV3032ClockMap relates the two clocks: sync() reads the hundredths register until it
+ticks and notes micros() at the tick, and times between (or after) the sync points are
+interpolated, so drift between the MCU clock and the RTC crystal is taken out.
+
+The capture holds the hundredth the event fell in, not the instant, so every latency is
+measured from the middle of that hundredth and carries up to +-5 ms of error on its own.
+Events arrive at random phases of the hundredths tick, so over many events the error
+averages out of the mean; the histogram is the real spread widened by a 10 ms wide box.
+
+  RV3032LatencyHistogram histogram;
+  RV3032LatencyProfiler profiler(rtc, histogram);
+  profiler.begin();
+  void onEvent() { profiler.handlerRan(); ... }
+  loop: profiler.update();
+
+Only the profiler talks to the RTC. extras/host/rv3032_latency_sim.cpp runs it against the
+simulator with known latencies.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include "SparkFun_RV3032.h"
+
+#define RV3032_LATENCY_TICK_MICROS         10000 // One hundredth, the resolution of the capture
+#define RV3032_LATENCY_SYNC_POINTS         4 // Clock map points kept
+#define RV3032_LATENCY_SYNC_INTERVAL_MS    10000 // update() adds a clock map point this often
+#define RV3032_LATENCY_SYNC_TIMEOUT_MS     30 // The hundredths register must tick within this
+
+#ifndef RV3032_LATENCY_BINS
+#define RV3032_LATENCY_BINS                32
+#endif
+
+//Maps RTC hundredths since 2000 to MCU micros() through the last RV3032_LATENCY_SYNC_POINTS points
+class RV3032ClockMap
+{
+public:
+
+	RV3032ClockMap( void );
+
+	void reset();
+	void addPoint(uint64_t hundredths, uint32_t mcuMicros); //Points must come in time order, at least once per micros() wrap
+	uint8_t getPoints();
+	bool toMicros(uint64_t hundredths, uint32_t &mcuMicros); //Interpolated between the points around it, extrapolated past the ends. false without a point
+	int32_t getDriftPpm(); //MCU clock against the RTC over the points kept, positive when the MCU runs fast
+
+  private:
+	uint64_t _hundredths[RV3032_LATENCY_SYNC_POINTS];
+	uint64_t _micros[RV3032_LATENCY_SYNC_POINTS]; //micros() extended to 64 bits
+	uint8_t _count = 0;
+	uint32_t _lastMicros = 0;
+};
+
+//Fixed width bins from firstMicros up, with counts for what falls either side
+class RV3032LatencyHistogram
+{
+public:
+
+	//The default starts one bin below -5 ms: the fastest handlers land there once the capture and clock map errors add up
+	RV3032LatencyHistogram(int32_t firstMicros = -RV3032_LATENCY_TICK_MICROS / 2 - 1000, uint32_t binMicros = 1000);
+
+	void reset();
+	void add(int32_t latencyMicros);
+
+	uint32_t getCount();
+	uint8_t getBins(); //RV3032_LATENCY_BINS
+	uint32_t getBin(uint8_t bin);
+	int32_t getBinStart(uint8_t bin);
+	uint32_t getUnderflow(); //Below firstMicros
+	uint32_t getOverflow(); //At or past the end of the last bin
+	int32_t getMin();
+	int32_t getMax();
+	int32_t getMean();
+	int32_t getPercentile(uint8_t percent); //Upper edge of the bin the percentile falls in, min or max if it falls outside the bins
+
+  private:
+	int32_t _first;
+	uint32_t _width;
+	uint32_t _bins[RV3032_LATENCY_BINS];
+	uint32_t _underflow;
+	uint32_t _overflow;
+	uint32_t _count;
+	int64_t _sum;
+	int32_t _min;
+	int32_t _max;
+};
+
+#if RV3032_ENABLE_EVI
+class RV3032LatencyProfiler
+{
+public:
+
+	RV3032LatencyProfiler(RV3032 &rtc, RV3032LatencyHistogram &histogram);
+
+	bool begin(); //Turns on EVI capture of the first event and adds the first clock map point. Call after rtc.begin()
+	bool sync(); //Adds a clock map point, busy for up to RV3032_LATENCY_SYNC_TIMEOUT_MS
+	void handlerRan(); //Call first thing in the event handler, no I2C so it is safe in an ISR
+	bool update(); //Call from loop(): true when an event was measured. Also keeps the clock map fresh
+
+	uint32_t getEvents(); //Latencies added to the histogram
+	uint32_t getMissed(); //Events that came too close together to be paired, or without a capture
+	RV3032ClockMap &getClockMap();
+
+  private:
+	RV3032 *_rtc;
+	RV3032LatencyHistogram *_histogram;
+	RV3032ClockMap _map;
+	RV3032EventBuffer _captures;
+	volatile uint32_t _handlerMicros = 0;
+	volatile bool _pending = false;
+	uint32_t _lastSync = 0;
+	uint32_t _events = 0;
+	uint32_t _missed = 0;
+};
+#endif
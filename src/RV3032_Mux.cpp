@@ -0,0 +1,301 @@
+/******************************************************************************
+RV3032_Mux.cpp
+RV3032 Arduino Library
+
+Several RV-3032s behind a TCA9548A style I2C multiplexer.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "RV3032_Mux.h"
+
+#define MICROS_PER_HUNDREDTH 10000
+
+RV3032Mux::RV3032Mux(uint8_t muxAddress)
+{
+	_muxAddress = muxAddress;
+	memset(_health, 0, sizeof(_health));
+}
+
+bool RV3032Mux::begin(TwoWire &wirePort)
+{
+	_i2cPort = &wirePort;
+	_selected = RV3032_MUX_NO_CHANNEL;
+	_channelWrites = 0;
+
+	return writeMux(0); //All channels off. false: Mux did not ack
+}
+
+int8_t RV3032Mux::addDevice(uint8_t channel)
+{
+	if (channel >= RV3032_MUX_CHANNELS || _count == RV3032_MUX_MAX_DEVICES)
+		return -1;
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (_channels[i] == channel)
+			return -1; //Same address on the same channel
+	}
+
+	uint8_t index = _count++;
+	_channels[index] = channel;
+	memset(&_health[index], 0, sizeof(RV3032MuxHealth));
+	_health[index].lastAgreed = true;
+	_devices[index].setEnergyMeter(_energyMeter);
+	_devices[index].setTraceRecorder(_traceRecorder);
+
+	if (writeChannel(channel) == false || _devices[index].begin(*_i2cPort) == false)
+		recordFailure(index);
+	return index;
+}
+
+uint8_t RV3032Mux::getDeviceCount()
+{
+	return _count;
+}
+
+RV3032 &RV3032Mux::getDevice(uint8_t index)
+{
+	return _devices[index < _count ? index : 0];
+}
+
+bool RV3032Mux::select(uint8_t index)
+{
+	if (index >= _count)
+		return false;
+	return writeChannel(_channels[index]);
+}
+
+bool RV3032Mux::deselect()
+{
+	return writeChannel(RV3032_MUX_NO_CHANNEL);
+}
+
+uint8_t RV3032Mux::getSelectedChannel()
+{
+	return _selected;
+}
+
+uint32_t RV3032Mux::getChannelWrites()
+{
+	return _channelWrites;
+}
+
+//The mux keeps its setting, so a write is only needed when the channel changes.
+//After a failed write the setting is unknown and the next select always writes
+bool RV3032Mux::writeChannel(uint8_t channel)
+{
+	if (channel == _selected)
+		return true;
+
+	if (writeMux(channel == RV3032_MUX_NO_CHANNEL ? 0 : (1 << channel)) == false)
+	{
+		_selected = RV3032_MUX_NO_CHANNEL;
+		return false; //Error: Mux did not ack
+	}
+	_selected = channel;
+	return true;
+}
+
+bool RV3032Mux::writeMux(uint8_t channelMask)
+{
+#if RV3032_ENABLE_TRACE
+	uint32_t start = (_traceRecorder != NULL) ? micros() : 0;
+#endif
+	_i2cPort->beginTransmission(_muxAddress);
+	_i2cPort->write(channelMask);
+	_channelWrites++;
+#if RV3032_ENABLE_ENERGY
+	if (_energyMeter != NULL)
+		_energyMeter->addTransaction(1);
+#endif
+
+	bool ack = (_i2cPort->endTransmission() == 0);
+#if RV3032_ENABLE_TRACE
+	if (_traceRecorder != NULL)
+	{
+		_traceRecorder->beginTransaction(_muxAddress, false, 1, start);
+		_traceRecorder->add(&channelMask, 1);
+		_traceRecorder->endTransaction(ack);
+	}
+#endif
+	return ack;
+}
+
+void RV3032Mux::setEnergyMeter(RV3032EnergyMeter *meter)
+{
+	_energyMeter = meter;
+	for (uint8_t i = 0; i < _count; i++)
+		_devices[i].setEnergyMeter(meter);
+}
+
+void RV3032Mux::setTraceRecorder(RV3032TraceRecorder *recorder)
+{
+	_traceRecorder = recorder;
+	for (uint8_t i = 0; i < _count; i++)
+		_devices[i].setTraceRecorder(recorder);
+}
+
+//Time, alarms, timer and status in one burst, and a sanity check of the time fields
+bool RV3032Mux::readDevice(uint8_t index, uint8_t * registers)
+{
+	if (select(index) == false)
+		return false;
+	if (_devices[index].readMultipleRegisters(RV3032_HUNDREDTHS, registers, RV3032_MUX_SNAPSHOT_LENGTH) == false)
+		return false;
+
+	//A missing device reads back as all ones
+	uint8_t seconds = registers[TIME_SECONDS] & 0x7F;
+	uint8_t month = registers[TIME_MONTH] & 0x1F;
+	uint8_t date = registers[TIME_DATE] & 0x3F;
+	if (seconds > 0x59 || month == 0 || month > 0x12 || date == 0 || date > 0x31 || registers[TIME_HOURS] > 0x23)
+		return false;
+	return true;
+}
+
+void RV3032Mux::recordFailure(uint8_t index)
+{
+	_health[index].failures++;
+	if (_health[index].consecutiveFailures < 0xFF)
+		_health[index].consecutiveFailures++;
+}
+
+/*********************************
+Reads every device once. With one RV-3032 per channel every device costs a mux write except the one
+on the channel already selected, so the pass starts there and goes round the list once.
+Each burst is corrected to the moment of the first one with the micros() difference between them,
+which leaves the hundredths resolution and the transfer time of one burst as the comparison error.
+*********************************/
+bool RV3032Mux::snapshot(RV3032MuxSnapshot &snap)
+{
+	uint32_t writesBefore = _channelWrites;
+	snap.count = _count;
+	snap.validMask = 0;
+	snap.agreeMask = 0;
+	snap.skewMs = 0;
+	snap.votedHundredths = 0;
+	snap.majority = false;
+
+	uint8_t start = 0;
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (_channels[i] == _selected)
+			start = i;
+	}
+
+	uint32_t firstMicros = 0;
+	bool first = true;
+	for (uint8_t n = 0; n < _count; n++)
+	{
+		uint8_t i = (start + n) % _count;
+		uint8_t registers[RV3032_MUX_SNAPSHOT_LENGTH];
+		snap.hundredths[i] = 0;
+		if (readDevice(i, registers) == false)
+		{
+			recordFailure(i);
+			continue;
+		}
+		snap.readMicros[i] = micros();
+		if (first == true)
+		{
+			firstMicros = snap.readMicros[i];
+			first = false;
+		}
+
+		RV3032MuxHealth &health = _health[i];
+		health.reads++;
+		health.consecutiveFailures = 0;
+		health.status = registers[RV3032_STATUS];
+		if (health.status & ((1 << STATUS_PORF) | (1 << STATUS_VLF)))
+			continue; //Answering, but the time is not to be trusted
+
+		uint32_t elapsed = snap.readMicros[i] - firstMicros;
+		snap.hundredths[i] = rv3032TimeToHundredths(registers) - (elapsed + MICROS_PER_HUNDREDTH / 2) / MICROS_PER_HUNDREDTH;
+		snap.validMask |= 1 << i;
+	}
+	snap.channelWrites = _channelWrites - writesBefore;
+
+	if (snap.validMask == 0)
+		return false;
+
+	//The clock with the most others inside the vote window sets the time, ties go to the lower index
+	uint8_t best = 0;
+	uint8_t bestVotes = 0;
+	uint8_t valid = 0;
+	uint64_t earliest = 0;
+	uint64_t latest = 0;
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if ((snap.validMask & (1 << i)) == 0)
+			continue;
+		if (valid == 0 || snap.hundredths[i] < earliest)
+			earliest = snap.hundredths[i];
+		if (valid == 0 || snap.hundredths[i] > latest)
+			latest = snap.hundredths[i];
+		valid++;
+
+		uint8_t votes = 0;
+		for (uint8_t j = 0; j < _count; j++)
+		{
+			if ((snap.validMask & (1 << j)) == 0)
+				continue;
+			uint64_t difference = snap.hundredths[i] > snap.hundredths[j] ? snap.hundredths[i] - snap.hundredths[j] : snap.hundredths[j] - snap.hundredths[i];
+			if (difference * 10 <= RV3032_MUX_VOTE_WINDOW_MS)
+				votes++;
+		}
+		if (votes > bestVotes)
+		{
+			best = i;
+			bestVotes = votes;
+		}
+	}
+
+	snap.skewMs = (latest - earliest) * 10;
+	snap.votedHundredths = snap.hundredths[best];
+	snap.majority = bestVotes * 2 > valid;
+
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if ((snap.validMask & (1 << i)) == 0)
+			continue; //Missed reads and lost power are tracked on their own
+		uint64_t difference = snap.hundredths[i] > snap.votedHundredths ? snap.hundredths[i] - snap.votedHundredths : snap.votedHundredths - snap.hundredths[i];
+		bool agrees = difference * 10 <= RV3032_MUX_VOTE_WINDOW_MS;
+		if (agrees == true)
+			snap.agreeMask |= 1 << i;
+		else if (snap.majority == true)
+			_health[i].outvoted++;
+		_health[i].lastAgreed = agrees || snap.majority == false; //Without a majority nobody is to blame
+	}
+	return true;
+}
+
+bool RV3032Mux::checkDevice(uint8_t index)
+{
+	if (index >= _count)
+		return false;
+
+	uint8_t status;
+	if (select(index) == false || _devices[index].readMultipleRegisters(RV3032_STATUS, &status, 1) == false)
+	{
+		recordFailure(index);
+		return false;
+	}
+	_health[index].consecutiveFailures = 0;
+	_health[index].status = status;
+	return true;
+}
+
+const RV3032MuxHealth &RV3032Mux::getHealth(uint8_t index)
+{
+	return _health[index < _count ? index : 0];
+}
+
+bool RV3032Mux::isHealthy(uint8_t index)
+{
+	if (index >= _count)
+		return false;
+	const RV3032MuxHealth &health = _health[index];
+	return health.consecutiveFailures < RV3032_MUX_FAILURE_LIMIT
+		&& (health.status & ((1 << STATUS_PORF) | (1 << STATUS_VLF))) == 0
+		&& health.lastAgreed == true;
+}
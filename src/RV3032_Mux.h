@@ -0,0 +1,113 @@
+/******************************************************************************
+RV3032_Mux.h
+RV3032 Arduino Library
+
+Several RV-3032s behind a TCA9548A style I2C multiplexer. All RV-3032s answer at 0x51,
+so each sits on its own mux channel and RV3032Mux selects the channel before talking
+to it. The last channel written is remembered, so a channel is only written when it
+changes, and snapshot() visits the devices starting from the channel that is already
+selected: one mux write per other device and none wasted.
+
+snapshot() reads the time and status of every clock with one burst each, corrects each
+reading to the moment of the first one with micros(), and reports the largest skew and
+the time most clocks agree on. Devices that fail to answer, report lost power or are
+outvoted lose health, see RV3032MuxHealth.
+
+  RV3032Mux mux;
+  mux.begin();
+  mux.addDevice(0);
+  mux.addDevice(3);
+  RV3032MuxSnapshot snap;
+  mux.snapshot(snap);
+  if (mux.select(1)) mux.getDevice(1).setCalibrationOffsetSteps(2);
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include "SparkFun_RV3032.h"
+
+#define RV3032_MUX_ADDR                    0x70 // TCA9548A with A0-A2 low
+#define RV3032_MUX_CHANNELS                8
+#define RV3032_MUX_NO_CHANNEL              0xFF
+
+#ifndef RV3032_MUX_MAX_DEVICES
+#define RV3032_MUX_MAX_DEVICES             8 // One RV-3032 per channel, lower it to save RAM
+#endif
+#if RV3032_MUX_MAX_DEVICES > RV3032_MUX_CHANNELS
+#error "RV3032_MUX_MAX_DEVICES can't be more than the 8 channels of the mux, the vote masks have one bit per device"
+#endif
+
+#define RV3032_MUX_VOTE_WINDOW_MS          20 // Clocks closer than this agree: two hundredths steps of read jitter
+#define RV3032_MUX_FAILURE_LIMIT           3 // Consecutive failed reads before a device is reported unhealthy
+#define RV3032_MUX_SNAPSHOT_LENGTH         14 // Registers 0x00-0x0D, time to status in one burst
+
+//Running record for one device, updated by snapshot() and checkDevice()
+struct RV3032MuxHealth
+{
+	uint32_t reads; //Successful snapshot reads
+	uint32_t failures; //Reads that NACKed or returned an impossible time
+	uint8_t consecutiveFailures;
+	uint32_t outvoted; //Snapshots in which this clock disagreed with the majority
+	uint8_t status; //STATUS register at the last read, PORF or VLF mean the time can't be trusted
+	bool lastAgreed; //Agreed with the majority in the last snapshot
+};
+
+//One pass over every device. Times are hundredths since 2000, corrected to the moment of the first read
+struct RV3032MuxSnapshot
+{
+	uint8_t count; //Devices visited
+	uint8_t validMask; //Bit i set if device i answered with a trustworthy time
+	uint8_t agreeMask; //Bit i set if device i agrees with the voted time
+	uint64_t hundredths[RV3032_MUX_MAX_DEVICES];
+	uint32_t readMicros[RV3032_MUX_MAX_DEVICES]; //micros() when each burst finished
+	uint32_t skewMs; //Largest difference between two valid clocks
+	uint64_t votedHundredths; //Time of the clock with the most others within RV3032_MUX_VOTE_WINDOW_MS
+	bool majority; //More than half of the valid clocks agree on votedHundredths
+	uint8_t channelWrites; //Mux writes the pass needed
+};
+
+class RV3032Mux
+{
+public:
+
+	RV3032Mux(uint8_t muxAddress = RV3032_MUX_ADDR);
+
+	bool begin(TwoWire &wirePort = Wire); //Checks that the mux answers and deselects every channel
+	int8_t addDevice(uint8_t channel); //Returns the device index, -1 if the channel is taken or there is no room, begin()s the RTC
+	uint8_t getDeviceCount();
+	RV3032 &getDevice(uint8_t index); //Talk to it after select(index)
+
+	bool select(uint8_t index); //Writes the mux only if the device's channel isn't selected already
+	bool deselect(); //Turns every channel off
+	uint8_t getSelectedChannel(); //RV3032_MUX_NO_CHANNEL if none or unknown
+	uint32_t getChannelWrites(); //Mux writes since begin()
+
+	//The mux writes and every device's transactions go to meter or recorder, NULL to stop. Call before begin() to include its write
+	void setEnergyMeter(RV3032EnergyMeter *meter);
+	void setTraceRecorder(RV3032TraceRecorder *recorder);
+
+	bool snapshot(RV3032MuxSnapshot &snap); //False if no device gave a valid time
+	bool checkDevice(uint8_t index); //Reads STATUS only, for polling health between snapshots
+	const RV3032MuxHealth &getHealth(uint8_t index);
+	bool isHealthy(uint8_t index); //Answering, no lost power and agreeing with the last vote
+
+  private:
+	bool writeChannel(uint8_t channel);
+	bool writeMux(uint8_t channelMask); //One byte write to the mux, counted and traced like the RTC's own transactions
+	bool readDevice(uint8_t index, uint8_t * registers);
+	void recordFailure(uint8_t index);
+
+	uint8_t _muxAddress;
+	TwoWire *_i2cPort = NULL;
+	RV3032 _devices[RV3032_MUX_MAX_DEVICES];
+	uint8_t _channels[RV3032_MUX_MAX_DEVICES];
+	RV3032MuxHealth _health[RV3032_MUX_MAX_DEVICES];
+	uint8_t _count = 0;
+	uint8_t _selected = RV3032_MUX_NO_CHANNEL;
+	uint32_t _channelWrites = 0;
+	RV3032EnergyMeter *_energyMeter = NULL; //Kept with the gates off so the layout never changes
+	RV3032TraceRecorder *_traceRecorder = NULL;
+};
@@ -0,0 +1,93 @@
+/******************************************************************************
+RV3032_Power.cpp
+RV3032 Arduino Library
+
+Energy accounting for RTC interactions.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "RV3032_Power.h"
+
+#define I2C_FRAME_BITS       11 // Start, address byte with ack, stop
+#define I2C_BYTE_BITS        9  // Data byte with ack
+
+RV3032EnergyMeter::RV3032EnergyMeter(uint32_t busHz, uint16_t activeMicroamps, uint16_t busMicroamps)
+{
+	_busHz = busHz;
+	_activeMicroamps = activeMicroamps;
+	_busMicroamps = busMicroamps;
+}
+
+void RV3032EnergyMeter::addTransaction(uint8_t bytes)
+{
+	_transactions++;
+	_bytes += bytes;
+	_busBits += I2C_FRAME_BITS + (uint32_t)bytes * I2C_BYTE_BITS;
+}
+
+void RV3032EnergyMeter::beginCycle(uint32_t nowMicros)
+{
+	_transactions = 0;
+	_bytes = 0;
+	_busBits = 0;
+	_awakeMicros = 0;
+	_startMicros = nowMicros;
+}
+
+void RV3032EnergyMeter::endCycle(uint32_t nowMicros)
+{
+	_awakeMicros = nowMicros - _startMicros;
+	_cycles++;
+	_totalNanoAs += getCycleChargeNanoAs();
+}
+
+uint16_t RV3032EnergyMeter::getCycleTransactions()
+{
+	return _transactions;
+}
+
+uint16_t RV3032EnergyMeter::getCycleBytes()
+{
+	return _bytes;
+}
+
+uint32_t RV3032EnergyMeter::getCycleBusMicros()
+{
+	return ((uint64_t)_busBits * 1000000 + _busHz - 1) / _busHz;
+}
+
+uint32_t RV3032EnergyMeter::getCycleAwakeMicros()
+{
+	uint32_t busMicros = getCycleBusMicros();
+	return _awakeMicros > busMicros ? _awakeMicros : busMicros;
+}
+
+//us * uA is pAs, so both terms are divided by 1000 for nAs
+uint32_t RV3032EnergyMeter::getCycleChargeNanoAs()
+{
+	uint64_t picoAs = (uint64_t)getCycleAwakeMicros() * _activeMicroamps + (uint64_t)getCycleBusMicros() * _busMicroamps;
+	return (picoAs + 500) / 1000;
+}
+
+uint32_t RV3032EnergyMeter::getCycles()
+{
+	return _cycles;
+}
+
+uint32_t RV3032EnergyMeter::getAverageChargeNanoAs()
+{
+	if (_cycles == 0)
+	{
+		return 0;
+	}
+	return _totalNanoAs / _cycles;
+}
+
+void RV3032EnergyMeter::reset()
+{
+	beginCycle(0);
+	_cycles = 0;
+	_totalNanoAs = 0;
+}
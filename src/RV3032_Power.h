@@ -0,0 +1,206 @@
+/******************************************************************************
+RV3032_Power.h
+RV3032 Arduino Library
+
+Power profiles and energy accounting for battery powered designs.
+
+RV3032PowerProfile describes the power related settings (backup switchover, trickle
+charger, EEPROM refresh, CLKOUT and the wake up sources) as a constexpr value like
+RV3032Config, but only the bits a profile names are changed, so it can be applied at
+any time with RV3032::setPowerProfile() without disturbing alarms or timers:
+
+  rtc.setPowerProfile(RV3032_POWER_COIN_CELL);
+  rtc.setPowerProfile(RV3032PowerProfile().backupSwitchover(BACKUP_SWITCHOVER_LEVEL).eepromRefresh(false));
+
+RV3032EnergyMeter is fed by the register read/write primitives once attached with
+setEnergyMeter(). It adds up transactions and bytes per wake cycle, converts them to
+bus time at the configured I2C clock and reports the charge each cycle costs.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+//Backup switchover modes (BSM)
+#define BACKUP_SWITCHOVER_DISABLED         0b00
+#define BACKUP_SWITCHOVER_DIRECT           0b01 // Switch when VDD drops below VBACKUP
+#define BACKUP_SWITCHOVER_LEVEL            0b10 // Switch when VDD drops below 2.0 V and VBACKUP is higher
+
+//Trickle charger modes (TCM) and series resistance (TCR)
+#define TRICKLE_CHARGER_OFF                0b00
+#define TRICKLE_CHARGER_1_75V              0b01
+#define TRICKLE_CHARGER_3_0V               0b10
+#define TRICKLE_CHARGER_4_5V               0b11
+#define TRICKLE_RESISTANCE_600             0b00
+#define TRICKLE_RESISTANCE_2K              0b01
+#define TRICKLE_RESISTANCE_7K              0b10
+#define TRICKLE_RESISTANCE_12K             0b11
+
+//Slots of a power profile, registers 0x10-0x14 then the PMU
+#define POWER_SLOT_CONTROL1                0
+#define POWER_SLOT_CONTROL2                1
+#define POWER_SLOT_CONTROL3                2
+#define POWER_SLOT_TS_CONTROL              3
+#define POWER_SLOT_CLOCK_INT_MASK          4
+#define POWER_SLOT_PMU                     5
+#define POWER_SLOTS                        6
+#define POWER_CONTROL_LENGTH               5 // Registers 0x10-0x14, read and written as one burst
+
+class RV3032PowerProfile
+{
+public:
+
+	//Changes nothing until a setting is added
+	constexpr RV3032PowerProfile( void )
+		: _value{0, 0, 0, 0, 0, 0}, _mask{0, 0, 0, 0, 0, 0}
+	{
+	}
+
+	//One of the BACKUP_SWITCHOVER settings
+	constexpr RV3032PowerProfile backupSwitchover(uint8_t mode) const
+	{
+		return set(POWER_SLOT_PMU, 3 << 4, mode << 4); //BSM
+	}
+
+	//Only for rechargeable backup cells. TRICKLE_CHARGER_OFF for primary cells
+	constexpr RV3032PowerProfile trickleCharger(uint8_t mode, uint8_t resistance = TRICKLE_RESISTANCE_12K) const
+	{
+		return set(POWER_SLOT_PMU, 0x0F, (resistance << 2) | mode); //TCR and TCM
+	}
+
+	//The daily refresh reloads the configuration RAM from EEPROM, undoing settings that were only written to RAM
+	constexpr RV3032PowerProfile eepromRefresh(bool enable) const
+	{
+		return set(POWER_SLOT_CONTROL1, 1 << 2, !enable << 2); //EERD
+	}
+
+	constexpr RV3032PowerProfile clockOutDisabled() const
+	{
+		return set(POWER_SLOT_PMU, 1 << 6, 1 << 6); //NCLKE
+	}
+
+	//CLKOUT stays off except while one of the interrupts in mask (register 0x14) is pending
+	constexpr RV3032PowerProfile clockOutOnInterrupt(uint8_t mask) const
+	{
+		return clockOutDisabled().set(POWER_SLOT_CONTROL2, 1 << 6, 1 << 6).set(POWER_SLOT_CLOCK_INT_MASK, 0xFF, mask); //CLKIE
+	}
+
+	constexpr RV3032PowerProfile switchoverInterrupt(bool enable) const
+	{
+		return set(POWER_SLOT_CONTROL3, 1 << 4, enable << 4); //BSIE
+	}
+
+	//The MCU only wakes on INT: no CLKOUT and no periodic update interrupt. Alarm, timer and EVI interrupts are kept
+	constexpr RV3032PowerProfile interruptOnly() const
+	{
+		return clockOutDisabled().set(POWER_SLOT_CONTROL2, (1 << 6) | (1 << 5), 0); //CLKIE and UIE
+	}
+
+	//Trickle charging together with switchover turned off is rejected, the charger would never have a cell to serve
+	constexpr bool isValid() const
+	{
+		return !((_value[POWER_SLOT_PMU] & 0x03) && (_mask[POWER_SLOT_PMU] & 0x30)
+			&& (((_value[POWER_SLOT_PMU] >> 4) & 3) == BACKUP_SWITCHOVER_DISABLED || ((_value[POWER_SLOT_PMU] >> 4) & 3) == 3));
+	}
+
+	constexpr uint8_t getValue(uint8_t slot) const
+	{
+		return _value[slot];
+	}
+
+	constexpr uint8_t getMask(uint8_t slot) const
+	{
+		return _mask[slot];
+	}
+
+	constexpr uint8_t apply(uint8_t slot, uint8_t current) const
+	{
+		return (current & ~_mask[slot]) | (_value[slot] & _mask[slot]);
+	}
+
+  private:
+	uint8_t _value[POWER_SLOTS];
+	uint8_t _mask[POWER_SLOTS];
+
+	constexpr RV3032PowerProfile(const RV3032PowerProfile &base, uint8_t slot, uint8_t mask, uint8_t value)
+		: _value{base.merge(0, slot, mask, value), base.merge(1, slot, mask, value), base.merge(2, slot, mask, value),
+			base.merge(3, slot, mask, value), base.merge(4, slot, mask, value), base.merge(5, slot, mask, value)},
+		_mask{(uint8_t)(base._mask[0] | (slot == 0 ? mask : 0)), (uint8_t)(base._mask[1] | (slot == 1 ? mask : 0)), (uint8_t)(base._mask[2] | (slot == 2 ? mask : 0)),
+			(uint8_t)(base._mask[3] | (slot == 3 ? mask : 0)), (uint8_t)(base._mask[4] | (slot == 4 ? mask : 0)), (uint8_t)(base._mask[5] | (slot == 5 ? mask : 0))}
+	{
+	}
+
+	constexpr uint8_t merge(uint8_t n, uint8_t slot, uint8_t mask, uint8_t value) const
+	{
+		return n == slot ? (uint8_t)((_value[n] & ~mask) | (value & mask)) : _value[n];
+	}
+
+	constexpr RV3032PowerProfile set(uint8_t slot, uint8_t mask, uint8_t value) const
+	{
+		return RV3032PowerProfile(*this, slot, mask, value);
+	}
+};
+
+//Primary lithium coin cell on VBACKUP: switch over on low VDD, never charge, no refresh, CLKOUT off
+constexpr RV3032PowerProfile RV3032_POWER_COIN_CELL = RV3032PowerProfile()
+	.backupSwitchover(BACKUP_SWITCHOVER_LEVEL)
+	.trickleCharger(TRICKLE_CHARGER_OFF)
+	.eepromRefresh(false)
+	.clockOutDisabled();
+
+//Supercap or rechargeable cell on VBACKUP, charged to 3.0 V through 2 kOhm while VDD is present
+constexpr RV3032PowerProfile RV3032_POWER_SUPERCAP = RV3032PowerProfile()
+	.backupSwitchover(BACKUP_SWITCHOVER_DIRECT)
+	.trickleCharger(TRICKLE_CHARGER_3_0V, TRICKLE_RESISTANCE_2K)
+	.eepromRefresh(false)
+	.clockOutDisabled();
+
+//Runs from VDD only, nothing on VBACKUP
+constexpr RV3032PowerProfile RV3032_POWER_MAINS = RV3032PowerProfile()
+	.backupSwitchover(BACKUP_SWITCHOVER_DISABLED)
+	.trickleCharger(TRICKLE_CHARGER_OFF)
+	.eepromRefresh(true);
+
+//Coin cell, and the MCU sleeps until the RTC raises INT
+constexpr RV3032PowerProfile RV3032_POWER_INTERRUPT_ONLY = RV3032_POWER_COIN_CELL.interruptOnly();
+
+#define ENERGY_DEFAULT_BUS_HZ              100000
+#define ENERGY_DEFAULT_ACTIVE_UA           5000 // MCU running
+#define ENERGY_DEFAULT_BUS_UA              1500 // Pull-up current while the bus is busy (two 2k2 to 3.3 V, half the time low)
+
+class RV3032EnergyMeter
+{
+public:
+
+	RV3032EnergyMeter(uint32_t busHz = ENERGY_DEFAULT_BUS_HZ, uint16_t activeMicroamps = ENERGY_DEFAULT_ACTIVE_UA, uint16_t busMicroamps = ENERGY_DEFAULT_BUS_UA);
+
+	void addTransaction(uint8_t bytes); //Called by the I/O primitives, bytes excludes the address byte
+
+	void beginCycle(uint32_t nowMicros); //Clears the cycle counters and starts timing the wake
+	void endCycle(uint32_t nowMicros); //Adds the cycle to the totals
+
+	uint16_t getCycleTransactions();
+	uint16_t getCycleBytes();
+	uint32_t getCycleBusMicros(); //Time on the bus at busHz, including start, address, ack and stop
+	uint32_t getCycleAwakeMicros(); //endCycle() - beginCycle(), never less than the bus time
+	uint32_t getCycleChargeNanoAs(); //Charge of the last cycle in nA*s (1000 is 1 uAs)
+
+	uint32_t getCycles();
+	uint32_t getAverageChargeNanoAs();
+	void reset();
+
+  private:
+	uint32_t _busHz;
+	uint16_t _activeMicroamps;
+	uint16_t _busMicroamps;
+	uint16_t _transactions = 0;
+	uint16_t _bytes = 0;
+	uint32_t _busBits = 0;
+	uint32_t _startMicros = 0;
+	uint32_t _awakeMicros = 0;
+	uint32_t _cycles = 0;
+	uint64_t _totalNanoAs = 0;
+};
@@ -0,0 +1,232 @@
+/******************************************************************************
+RV3032_Time.cpp
+RV3032 Arduino Library
+
+Calendar math and compact binary timestamps for RV-3032 time images.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "RV3032_Time.h"
+
+#define DAYS_PER_FOUR_YEARS 1461 // 2000 is a leap year, so every 4 year block starts with one
+
+//Days before the first of each month in a non leap year
+static const uint16_t daysBeforeMonth[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
+uint8_t rv3032BCDtoDEC(uint8_t val)
+{
+	return ( ( val / 0x10) * 10 ) + ( val % 0x10 );
+}
+
+uint16_t rv3032DaysSince2000(uint8_t year, uint8_t month, uint8_t date)
+{
+	if (month < 1 || month > 12)
+	{
+		month = 1; //Raw register data can hold any month, keep it inside the table
+	}
+	if (date < 1)
+	{
+		date = 1; //Keeps the first day of 2000 from wrapping
+	}
+	uint16_t days = year * 365 + (year + 3) / 4; //Leap days of the years before this one
+	days += daysBeforeMonth[month - 1] + date - 1;
+	if (month > 2 && (year % 4) == 0)
+	{
+		days++;
+	}
+	return days;
+}
+
+void rv3032DateFromDays(uint16_t days, uint8_t &year, uint8_t &month, uint8_t &date)
+{
+	year = (days / DAYS_PER_FOUR_YEARS) * 4;
+	uint16_t dayOfYear = days % DAYS_PER_FOUR_YEARS;
+	bool leap = true;
+	if (dayOfYear >= 366)
+	{
+		dayOfYear -= 366;
+		year += 1 + dayOfYear / 365;
+		dayOfYear %= 365;
+		leap = false;
+	}
+
+	if (leap && dayOfYear >= 59)
+	{
+		if (dayOfYear == 59)
+		{
+			month = 2;
+			date = 29;
+			return;
+		}
+		dayOfYear--;
+	}
+
+	month = 12;
+	while (daysBeforeMonth[month - 1] > dayOfYear)
+	{
+		month--;
+	}
+	date = dayOfYear - daysBeforeMonth[month - 1] + 1;
+}
+
+//Seconds since 2000-01-01, fits in 32 bits for the whole range of the RTC
+static uint32_t secondsSince2000(const uint8_t * time)
+{
+	uint32_t days = rv3032DaysSince2000(rv3032BCDtoDEC(time[7]), rv3032BCDtoDEC(time[6] & 0x1F), rv3032BCDtoDEC(time[5] & 0x3F));
+	uint32_t seconds = rv3032BCDtoDEC(time[3] & 0x3F) * 3600UL + rv3032BCDtoDEC(time[2] & 0x7F) * 60 + rv3032BCDtoDEC(time[1] & 0x7F);
+	return days * 86400UL + seconds;
+}
+
+uint32_t rv3032TimeToEpoch(const uint8_t * time)
+{
+	return RV3032_EPOCH_2000 + secondsSince2000(time);
+}
+
+uint64_t rv3032TimeToHundredths(const uint8_t * time)
+{
+	return (uint64_t)secondsSince2000(time) * 100 + rv3032BCDtoDEC(time[0]);
+}
+
+static uint8_t toBCD(uint8_t val)
+{
+	return ( ( val / 10 ) * 0x10 ) + ( val % 10 );
+}
+
+static void secondsToTime(uint32_t seconds, uint8_t hundredths, uint8_t * time)
+{
+	uint16_t days = seconds / 86400UL;
+	seconds %= 86400UL;
+
+	uint8_t year, month, date;
+	rv3032DateFromDays(days, year, month, date);
+
+	time[0] = toBCD(hundredths);
+	time[1] = toBCD(seconds % 60);
+	time[2] = toBCD((seconds / 60) % 60);
+	time[3] = toBCD(seconds / 3600);
+	time[4] = (days + 6) % 7; //0 = Sunday, 2000-01-01 was a Saturday
+	time[5] = toBCD(date);
+	time[6] = toBCD(month);
+	time[7] = toBCD(year);
+}
+
+void rv3032HundredthsToTime(uint64_t hundredths, uint8_t * time)
+{
+	secondsToTime(hundredths / 100, hundredths % 100, time);
+}
+
+void rv3032EpochToTime(uint32_t epoch, uint8_t * time)
+{
+	secondsToTime(epoch - RV3032_EPOCH_2000, 0, time);
+}
+
+void rv3032Pack40(uint64_t hundredths, uint8_t * dest)
+{
+	for (uint8_t i = 0; i < RV3032_PACKED_LENGTH; i++)
+	{
+		dest[i] = hundredths & 0xFF;
+		hundredths >>= 8;
+	}
+}
+
+uint64_t rv3032Unpack40(const uint8_t * src)
+{
+	uint64_t hundredths = 0;
+	for (uint8_t i = RV3032_PACKED_LENGTH; i > 0; i--)
+	{
+		hundredths = (hundredths << 8) | src[i - 1];
+	}
+	return hundredths;
+}
+
+//****************************************************************************//
+//
+//  Streaming encoder
+//
+//****************************************************************************//
+
+static uint8_t writeVarint(uint64_t value, uint8_t * dest)
+{
+	uint8_t len = 0;
+	while (value >= 0x80)
+	{
+		dest[len++] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	dest[len++] = value;
+	return len;
+}
+
+RV3032TimeEncoder::RV3032TimeEncoder(uint16_t keyframeInterval)
+{
+	_keyframeInterval = keyframeInterval;
+}
+
+uint8_t RV3032TimeEncoder::encode(uint64_t hundredths, uint8_t * dest)
+{
+	uint64_t value;
+	if (_primed == false || hundredths < _last || _sinceKeyframe >= _keyframeInterval)
+	{
+		value = (hundredths << 1) | 1;
+		_sinceKeyframe = 0;
+		_primed = true;
+	}
+	else
+	{
+		value = (hundredths - _last) << 1;
+		_sinceKeyframe++;
+	}
+	_last = hundredths;
+	return writeVarint(value, dest);
+}
+
+void RV3032TimeEncoder::reset()
+{
+	_primed = false;
+}
+
+RV3032TimeDecoder::RV3032TimeDecoder( void )
+{
+
+}
+
+uint8_t RV3032TimeDecoder::decode(const uint8_t * src, uint8_t len, uint64_t &hundredths, bool &valid)
+{
+	uint64_t value = 0;
+	uint8_t used = 0;
+	while (true)
+	{
+		if (used == len || used == RV3032_STREAM_MAX_LENGTH)
+			return 0; //Incomplete or corrupt record
+		uint8_t b = src[used];
+		value |= (uint64_t)(b & 0x7F) << (7 * used);
+		used++;
+		if ((b & 0x80) == 0)
+			break;
+	}
+
+	if (value & 1)
+	{
+		_last = value >> 1;
+		_primed = true;
+	}
+	else if (_primed)
+	{
+		_last += value >> 1;
+	}
+	else
+	{
+		valid = false; //A delta without a keyframe to apply it to
+		return used;
+	}
+	hundredths = _last;
+	valid = true;
+	return used;
+}
+
+void RV3032TimeDecoder::reset()
+{
+	_primed = false;
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+RV3032_Time.h
+RV3032 Arduino Library
+
+Calendar math and compact binary timestamps for RV-3032 time images.
+Nothing in here depends on Arduino, so the same code runs on the device and on a host
+that decodes logs.
+
+A time image is the 8 byte register layout of _time (see time_order), all values BCD.
+Timestamps count hundredths of a second since 2000-01-01 00:00:00 and fit in 40 bits
+for the whole 2000-2099 range of the RTC.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#define RV3032_EPOCH_2000                  946684800UL // UNIX time of 2000-01-01 00:00:00
+#define RV3032_PACKED_LENGTH               5 // Bytes in a packed 40 bit timestamp
+#define RV3032_STREAM_MAX_LENGTH           6 // Longest record written by RV3032TimeEncoder
+
+uint8_t rv3032BCDtoDEC(uint8_t val);
+
+//Calendar helpers, valid for 2000-2099. year is 0-99, month 1-12, date 1-31
+//A month outside 1-12 is taken as January and date 0 as the 1st
+uint16_t rv3032DaysSince2000(uint8_t year, uint8_t month, uint8_t date);
+void rv3032DateFromDays(uint16_t days, uint8_t &year, uint8_t &month, uint8_t &date);
+
+uint32_t rv3032TimeToEpoch(const uint8_t * time); //BCD time image to UNIX epoch seconds, always UTC
+uint64_t rv3032TimeToHundredths(const uint8_t * time); //BCD time image to hundredths since 2000
+void rv3032HundredthsToTime(uint64_t hundredths, uint8_t * time); //Hundredths since 2000 to a BCD time image, weekday included as 0 (Sunday) to 6
+void rv3032EpochToTime(uint32_t epoch, uint8_t * time); //UNIX epoch seconds (UTC, 2000 or later) to a BCD time image, hundredths cleared
+
+void rv3032Pack40(uint64_t hundredths, uint8_t * dest); //Little endian, RV3032_PACKED_LENGTH bytes
+uint64_t rv3032Unpack40(const uint8_t * src);
+
+/*********************************
+Delta encoder for consecutive timestamps.
+Each record is one LEB128 varint: (delta << 1) for a forward step from the previous record,
+or (hundredths << 1) | 1 for an absolute keyframe. Keyframes are written for the first record,
+when time goes backwards, and every keyframeInterval records so a damaged log can resync.
+A one second step costs 2 bytes, a keyframe 6.
+*********************************/
+class RV3032TimeEncoder
+{
+public:
+
+	RV3032TimeEncoder(uint16_t keyframeInterval = 256);
+
+	uint8_t encode(uint64_t hundredths, uint8_t * dest); //Returns the number of bytes written to dest (at most RV3032_STREAM_MAX_LENGTH)
+	void reset(); //The next record will be a keyframe
+
+  private:
+	uint64_t _last = 0;
+	uint16_t _keyframeInterval;
+	uint16_t _sinceKeyframe = 0;
+	bool _primed = false;
+};
+
+class RV3032TimeDecoder
+{
+public:
+
+	RV3032TimeDecoder( void );
+
+	//Returns bytes consumed, 0 if the record is incomplete or corrupt. valid is false for deltas seen before the first keyframe
+	uint8_t decode(const uint8_t * src, uint8_t len, uint64_t &hundredths, bool &valid);
+	void reset();
+
+  private:
+	uint64_t _last = 0;
+	bool _primed = false;
+};
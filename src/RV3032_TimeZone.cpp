@@ -0,0 +1,237 @@
+/******************************************************************************
+RV3032_TimeZone.cpp
+RV3032 Arduino Library
+
+POSIX TZ rule engine with cached DST transitions. See RV3032_TimeZone.h.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "RV3032_TimeZone.h"
+#include "RV3032_Time.h"
+
+#define SECONDS_PER_DAY 86400UL
+#define DEFAULT_TRANSITION_TIME 7200 // 02:00:00 local when a rule has no /time
+
+static const uint8_t daysInMonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+static bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static const char * parseNumber(const char * s, uint16_t &value)
+{
+	if (!isDigit(*s))
+		return 0;
+	value = 0;
+	while (isDigit(*s))
+	{
+		value = value * 10 + (*s++ - '0');
+	}
+	return s;
+}
+
+//Zone names are three or more letters, or anything between < and > (e.g. <+0530>)
+static const char * parseName(const char * s)
+{
+	const char * begin = s;
+	if (*s == '<')
+	{
+		while (*s && *s != '>')
+			s++;
+		return (*s == '>') ? s + 1 : 0;
+	}
+	while ((*s >= 'A' && *s <= 'Z') || (*s >= 'a' && *s <= 'z'))
+		s++;
+	return (s - begin >= 3) ? s : 0;
+}
+
+//[+|-]hh[:mm[:ss]] in seconds
+static const char * parseTime(const char * s, int32_t &seconds)
+{
+	bool negative = false;
+	if (*s == '+' || *s == '-')
+	{
+		negative = (*s == '-');
+		s++;
+	}
+
+	uint16_t part;
+	if ((s = parseNumber(s, part)) == 0)
+		return 0;
+	seconds = part * 3600L;
+	for (uint8_t i = 0; i < 2 && *s == ':'; i++)
+	{
+		if ((s = parseNumber(s + 1, part)) == 0)
+			return 0;
+		seconds += (i == 0) ? part * 60L : part;
+	}
+
+	if (negative)
+		seconds = -seconds;
+	return s;
+}
+
+static const char * parseRule(const char * s, uint8_t &type, uint8_t &month, uint8_t &week, uint8_t &weekday, uint16_t &day, int32_t &time)
+{
+	uint16_t value;
+	if (*s == 'M')
+	{
+		type = 'M';
+		if ((s = parseNumber(s + 1, value)) == 0 || value < 1 || value > 12 || *s != '.')
+			return 0;
+		month = value;
+		if ((s = parseNumber(s + 1, value)) == 0 || value < 1 || value > 5 || *s != '.')
+			return 0;
+		week = value;
+		if ((s = parseNumber(s + 1, value)) == 0 || value > 6)
+			return 0;
+		weekday = value;
+	}
+	else
+	{
+		type = 'D';
+		if (*s == 'J')
+		{
+			type = 'J';
+			s++;
+		}
+		if ((s = parseNumber(s, value)) == 0 || value > 365 || (type == 'J' && value == 0))
+			return 0;
+		day = value;
+	}
+
+	time = DEFAULT_TRANSITION_TIME;
+	if (*s == '/')
+		s = parseTime(s + 1, time);
+	return s;
+}
+
+RV3032TimeZone::RV3032TimeZone( void )
+{
+
+}
+
+bool RV3032TimeZone::setRule(const char * tz)
+{
+	int32_t stdOffset, dstOffset;
+	transitionRule start, end;
+	bool hasDST = false;
+
+	const char * s = parseName(tz);
+	if (s == 0 || (s = parseTime(s, stdOffset)) == 0)
+		return false;
+	stdOffset = -stdOffset; //POSIX counts hours west of UTC
+	dstOffset = stdOffset + 3600;
+
+	if (*s != '\0')
+	{
+		hasDST = true;
+		if ((s = parseName(s)) == 0)
+			return false;
+		if (*s != ',' && *s != '\0')
+		{
+			if ((s = parseTime(s, dstOffset)) == 0)
+				return false;
+			dstOffset = -dstOffset;
+		}
+
+		const char * rules = (*s == ',') ? s : ",M3.2.0,M11.1.0"; //No rule given, use the US one like most libcs
+		s = parseRule(rules + 1, start.type, start.month, start.week, start.weekday, start.day, start.time);
+		if (s == 0 || *s != ',')
+			return false;
+		s = parseRule(s + 1, end.type, end.month, end.week, end.weekday, end.day, end.time);
+		if (s == 0 || *s != '\0')
+			return false;
+	}
+
+	_stdOffset = stdOffset;
+	_dstOffset = hasDST ? dstOffset : stdOffset;
+	_hasDST = hasDST;
+	_start = start;
+	_end = end;
+	_cachedYear = 0;
+	return true;
+}
+
+//UTC time of a transition in the given year. offsetBefore is the offset in effect just before it
+uint32_t RV3032TimeZone::transitionTime(uint16_t year, const transitionRule &rule, int32_t offsetBefore)
+{
+	uint8_t y = year - 2000;
+	bool leap = (y % 4) == 0;
+	uint16_t days = rv3032DaysSince2000(y, 1, 1);
+
+	if (rule.type == 'M')
+	{
+		uint16_t first = rv3032DaysSince2000(y, rule.month, 1);
+		uint8_t firstWeekday = (first + 6) % 7; //2000-01-01 was a Saturday
+		uint8_t date = 1 + (rule.weekday + 7 - firstWeekday) % 7 + (rule.week - 1) * 7;
+		uint8_t length = daysInMonth[rule.month - 1] + ((rule.month == 2 && leap) ? 1 : 0);
+		if (date > length)
+			date -= 7; //Week 5 means the last one
+		days = first + date - 1;
+	}
+	else if (rule.type == 'J')
+	{
+		days += rule.day - 1 + ((leap && rule.day >= 60) ? 1 : 0); //Feb 29 is never counted
+	}
+	else
+	{
+		days += rule.day;
+	}
+
+	return RV3032_EPOCH_2000 + days * SECONDS_PER_DAY + rule.time - offsetBefore;
+}
+
+void RV3032TimeZone::cacheYear(uint16_t year)
+{
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		_yearStart[i] = RV3032_EPOCH_2000 + rv3032DaysSince2000(year + i - 2000, 1, 1) * SECONDS_PER_DAY;
+	}
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		_dstStart[i] = transitionTime(year + i, _start, _stdOffset);
+		_dstEnd[i] = transitionTime(year + i, _end, _dstOffset);
+	}
+	_cachedYear = year;
+}
+
+bool RV3032TimeZone::isDST(uint32_t utc)
+{
+	if (_hasDST == false)
+		return false;
+
+	if (_cachedYear == 0 || utc < _yearStart[0] || utc >= _yearStart[2])
+	{
+		uint8_t year = 0, month, date;
+		if (utc > RV3032_EPOCH_2000)
+			rv3032DateFromDays((utc - RV3032_EPOCH_2000) / SECONDS_PER_DAY, year, month, date);
+		cacheYear(2000 + (year > 98 ? 98 : year)); //The next year must still be in range
+	}
+
+	uint8_t i = (utc >= _yearStart[1]) ? 1 : 0;
+	if (_dstStart[i] < _dstEnd[i])
+		return utc >= _dstStart[i] && utc < _dstEnd[i];
+	return utc < _dstEnd[i] || utc >= _dstStart[i]; //Southern hemisphere, DST spans the new year
+}
+
+int32_t RV3032TimeZone::getOffset(uint32_t utc)
+{
+	return isDST(utc) ? _dstOffset : _stdOffset;
+}
+
+uint32_t RV3032TimeZone::utcToLocal(uint32_t utc)
+{
+	return utc + getOffset(utc);
+}
+
+uint32_t RV3032TimeZone::localToUtc(uint32_t local)
+{
+	uint32_t utc = local - _dstOffset;
+	if (isDST(utc))
+		return utc;
+	return local - _stdOffset;
+}
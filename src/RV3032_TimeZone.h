@@ -0,0 +1,56 @@
+/******************************************************************************
+RV3032_TimeZone.h
+RV3032 Arduino Library
+
+Keep the RTC in UTC and convert to local time with a POSIX TZ rule such as
+"CET-1CEST,M3.5.0,M10.5.0/3" or "AEST-10AEDT,M10.1.0,M4.1.0/3".
+The DST transitions of the current and the next year are worked out once and cached,
+so every conversion after that is a couple of compares. Does not depend on Arduino
+or on the libc time zone.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+class RV3032TimeZone
+{
+public:
+
+	RV3032TimeZone( void ); //UTC until setRule() is called
+
+	bool setRule(const char * tz); //Returns false if the rule can't be parsed, the zone is left unchanged
+
+	uint32_t utcToLocal(uint32_t utc);
+	uint32_t localToUtc(uint32_t local); //Times repeated at the end of DST map to the DST one, skipped times to standard time
+	int32_t getOffset(uint32_t utc); //Seconds east of UTC in effect at utc
+	bool isDST(uint32_t utc);
+
+  private:
+	struct transitionRule
+	{
+		uint8_t type; //'M' month/week/day, 'J' julian day 1-365 without Feb 29, 'D' day 0-365
+		uint8_t month;
+		uint8_t week;
+		uint8_t weekday;
+		uint16_t day;
+		int32_t time; //Seconds after local midnight, may be negative or over 24 hours
+	};
+
+	uint32_t transitionTime(uint16_t year, const transitionRule &rule, int32_t offsetBefore);
+	void cacheYear(uint16_t year);
+
+	int32_t _stdOffset = 0; //Seconds east of UTC
+	int32_t _dstOffset = 0;
+	bool _hasDST = false;
+	transitionRule _start;
+	transitionRule _end;
+
+	uint16_t _cachedYear = 0; //0 means nothing cached yet
+	uint32_t _yearStart[3]; //UTC midnight of Jan 1 of the cached year, the next one and the one after
+	uint32_t _dstStart[2]; //UTC transition times for the cached year and the next one
+	uint32_t _dstEnd[2];
+};
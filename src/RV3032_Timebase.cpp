@@ -0,0 +1,157 @@
+/******************************************************************************
+RV3032_Timebase.cpp
+RV3032 Arduino Library
+
+CLKOUT disciplined timebase and MCU oscillator measurement.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "RV3032_Timebase.h"
+
+#define MICROS_PER_SECOND      1000000
+#define MICROS_PER_HUNDREDTH   10000
+
+RV3032Timebase::RV3032Timebase(uint32_t clockHz, uint8_t counterBits)
+{
+	setClock(clockHz, counterBits);
+}
+
+void RV3032Timebase::setClock(uint32_t clockHz, uint8_t counterBits)
+{
+	_clockHz = clockHz;
+	_mask = (counterBits >= 32) ? 0xFFFFFFFF : (((uint32_t)1 << counterBits) - 1);
+	_ticks = 0;
+	_primed = false;
+	_hasReference = false;
+}
+
+uint64_t RV3032Timebase::extend(uint32_t counter)
+{
+	counter &= _mask;
+	if (_primed == true)
+	{
+		_ticks += (counter - _lastCounter) & _mask; //Modular difference, correct across one wrap
+	}
+	_primed = true;
+	_lastCounter = counter;
+	return _ticks;
+}
+
+uint64_t RV3032Timebase::getTicks()
+{
+	return _ticks;
+}
+
+uint64_t RV3032Timebase::ticksToMicros(uint64_t ticks)
+{
+	//Whole seconds first so ticks * 1000000 can't overflow
+	return (ticks / _clockHz) * MICROS_PER_SECOND + ((ticks % _clockHz) * MICROS_PER_SECOND) / _clockHz;
+}
+
+uint64_t RV3032Timebase::getMicros(uint32_t counter)
+{
+	return ticksToMicros(extend(counter));
+}
+
+void RV3032Timebase::setReference(uint32_t counter, uint64_t hundredths)
+{
+	_referenceTicks = extend(counter);
+	_referenceMicros = hundredths * MICROS_PER_HUNDREDTH;
+	_hasReference = true;
+}
+
+bool RV3032Timebase::hasReference()
+{
+	return _hasReference;
+}
+
+uint64_t RV3032Timebase::getTimestampMicros(uint32_t counter)
+{
+	uint64_t ticks = extend(counter);
+	if (_hasReference == false)
+	{
+		return 0;
+	}
+	return _referenceMicros + ticksToMicros(ticks - _referenceTicks);
+}
+
+RV3032OscillatorCal::RV3032OscillatorCal(uint32_t nominalHz, uint32_t referenceHz)
+{
+	_nominalHz = nominalHz;
+	_referenceHz = referenceHz;
+}
+
+void RV3032OscillatorCal::reset()
+{
+	_spanTicks = 0;
+	_spanEdges = 0;
+	_primed = false;
+}
+
+void RV3032OscillatorCal::addCapture(uint32_t mcuTicks, uint32_t referenceEdges)
+{
+	if (_primed == false)
+	{
+		_firstTicks = mcuTicks;
+		_firstEdges = referenceEdges;
+		_primed = true;
+		return;
+	}
+	_spanTicks = mcuTicks - _firstTicks;
+	_spanEdges = referenceEdges - _firstEdges;
+}
+
+uint32_t RV3032OscillatorCal::getSpanEdges()
+{
+	return _spanEdges;
+}
+
+bool RV3032OscillatorCal::isReady(uint32_t minimumEdges)
+{
+	return (_spanEdges > 0 && _spanEdges >= minimumEdges);
+}
+
+uint32_t RV3032OscillatorCal::getMeasuredHz()
+{
+	if (_spanEdges == 0)
+	{
+		return 0;
+	}
+	return ((uint64_t)_spanTicks * _referenceHz + _spanEdges / 2) / _spanEdges;
+}
+
+int32_t RV3032OscillatorCal::getErrorPpm()
+{
+	if (_spanEdges == 0)
+	{
+		return 0;
+	}
+	//Ticks counted minus ticks expected, both scaled by the reference frequency
+	int64_t difference = (int64_t)((uint64_t)_spanTicks * _referenceHz) - (int64_t)((uint64_t)_nominalHz * _spanEdges);
+	uint64_t expected = (uint64_t)_nominalHz * _spanEdges;
+	if (expected < 64)
+	{
+		return 0; //Too short a span (or no nominal frequency) to resolve any error
+	}
+	//1000000 = 15625 * 64, keeps difference * 1000000 inside 64 bits for errors well beyond any RC oscillator
+	return (difference * 15625) / (int64_t)(expected / 64);
+}
+
+int16_t RV3032OscillatorCal::suggestTrim(int16_t currentTrim, int32_t ppmPerStep, int16_t minimumTrim, int16_t maximumTrim)
+{
+	if (ppmPerStep == 0 || _spanEdges == 0)
+	{
+		return currentTrim;
+	}
+	int32_t error = getErrorPpm();
+	//Round the number of steps to the nearest whole step
+	int32_t steps = (error >= 0) == (ppmPerStep >= 0)
+		? -((error + ppmPerStep / 2) / ppmPerStep)
+		: -((error - ppmPerStep / 2) / ppmPerStep);
+	int32_t trim = currentTrim + steps;
+	if (trim < minimumTrim) trim = minimumTrim;
+	if (trim > maximumTrim) trim = maximumTrim;
+	return trim;
+}
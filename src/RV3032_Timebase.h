@@ -0,0 +1,96 @@
+/******************************************************************************
+RV3032_Timebase.h
+RV3032 Arduino Library
+
+Use CLKOUT as a hardware timebase. Route CLKOUT (32768 Hz for 30.5 us resolution) to
+the external clock input of an MCU timer and feed the raw counter to RV3032Timebase:
+it extends the counter to 64 bits, converts ticks to microseconds and, once anchored
+to an RTC reading, to timestamps. Reading the time then costs a register read on the
+MCU and no I2C traffic at all, and it keeps the accuracy of the RTC crystal.
+
+RV3032OscillatorCal uses the same reference to measure the MCU clock (or its internal
+RC oscillator) and to work out the trim that brings it closest to nominal.
+
+Nothing in here depends on Arduino, so it can be exercised on a host with simulated
+edges (see extras/host/rv3032_timebase_sim.cpp).
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#define RV3032_TIMEBASE_DEFAULT_HZ         32768 // CLKOUT_FREQUENCY_32768_HZ
+
+/*********************************
+Extends a free running hardware counter clocked by CLKOUT.
+extend() must see the counter at least once per wrap (2 s for a 16 bit counter at 32768 Hz),
+from one context only: call it from the timer overflow interrupt, or from the main loop with
+interrupts off while reading the counter.
+*********************************/
+class RV3032Timebase
+{
+public:
+
+	RV3032Timebase(uint32_t clockHz = RV3032_TIMEBASE_DEFAULT_HZ, uint8_t counterBits = 16);
+
+	void setClock(uint32_t clockHz, uint8_t counterBits); //Restarts the count
+
+	uint64_t extend(uint32_t counter); //Returns ticks since the first call, never goes backwards
+	uint64_t getTicks(); //Value returned by the last extend()
+	uint64_t ticksToMicros(uint64_t ticks);
+	uint64_t getMicros(uint32_t counter); //extend() in microseconds
+
+	//Ties the tick count to the RTC. Call it with the counter read right after the RTC second changed
+	//(UF interrupt, or syncToEdge) and the RTC time as hundredths since 2000
+	void setReference(uint32_t counter, uint64_t hundredths);
+	bool hasReference();
+	uint64_t getTimestampMicros(uint32_t counter); //Microseconds since 2000-01-01, 0 without a reference
+
+  private:
+	uint32_t _clockHz;
+	uint32_t _mask;
+	uint32_t _lastCounter = 0;
+	uint64_t _ticks = 0;
+	bool _primed = false;
+	uint64_t _referenceTicks = 0;
+	uint64_t _referenceMicros = 0;
+	bool _hasReference = false;
+};
+
+/*********************************
+Measures an MCU clock against the CLKOUT reference.
+Pass captures of (MCU timer value, reference edge count) pairs, for example the input capture
+register and an edge counter from the capture interrupt, or micros() next to an edge count.
+Only the first and the last capture are used, so the result improves with the time between them:
+one MCU tick of uncertainty over one second of 1 MHz ticks is 1 ppm.
+*********************************/
+class RV3032OscillatorCal
+{
+public:
+
+	RV3032OscillatorCal(uint32_t nominalHz, uint32_t referenceHz = RV3032_TIMEBASE_DEFAULT_HZ);
+
+	void reset();
+	void addCapture(uint32_t mcuTicks, uint32_t referenceEdges); //Both may wrap, the spans must not
+	uint32_t getSpanEdges(); //Reference edges between the first and last capture
+	bool isReady(uint32_t minimumEdges); //True once the captures span at least minimumEdges
+
+	uint32_t getMeasuredHz();
+	int32_t getErrorPpm(); //Positive when the MCU clock runs fast, 0 until nominal Hz times edges reaches 64
+
+	//Trim that should cancel the error, for a trim register where each step moves the clock by ppmPerStep
+	//(negative if a higher setting slows the clock). Clamped to minimumTrim..maximumTrim
+	int16_t suggestTrim(int16_t currentTrim, int32_t ppmPerStep, int16_t minimumTrim, int16_t maximumTrim);
+
+  private:
+	uint32_t _nominalHz;
+	uint32_t _referenceHz;
+	uint32_t _firstTicks = 0;
+	uint32_t _firstEdges = 0;
+	uint32_t _spanTicks = 0;
+	uint32_t _spanEdges = 0;
+	bool _primed = false;
+};
@@ -0,0 +1,217 @@
+/******************************************************************************
+RV3032_Trace.cpp
+RV3032 Arduino Library
+
+Bus traffic recorder and trace reader.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "RV3032_Trace.h"
+#include <string.h>
+
+RV3032TraceRecorder::RV3032TraceRecorder(uint8_t * buffer, uint16_t size, void (*flush)(const uint8_t * data, uint16_t len))
+{
+	_buffer = buffer;
+	_size = size;
+	_flush = flush;
+	clear();
+}
+
+void RV3032TraceRecorder::clear()
+{
+	_length = 0;
+	_open = false;
+	_primed = false;
+	_transactions = 0;
+	_dropped = 0;
+	if (_size >= RV3032_TRACE_MAGIC_LENGTH)
+	{
+		memcpy(_buffer, RV3032_TRACE_MAGIC, RV3032_TRACE_MAGIC_LENGTH);
+		_length = RV3032_TRACE_MAGIC_LENGTH;
+	}
+}
+
+void RV3032TraceRecorder::flush()
+{
+	if (_flush == NULL || _open == true || _length == 0)
+		return;
+	_flush(_buffer, _length);
+	_length = 0; //Chunks after the first carry no magic, so they can be appended to one file
+}
+
+//Makes room for len bytes, flushing if there is a callback
+bool RV3032TraceRecorder::reserve(uint16_t len)
+{
+	if (_size - _length >= len)
+		return true;
+	flush();
+	return (_size - _length >= len);
+}
+
+//LEB128, 7 bits per byte, low bits first
+void RV3032TraceRecorder::putDelta(uint32_t nowMicros)
+{
+	uint32_t delta = _primed ? nowMicros - _lastMicros : 0;
+	_primed = true;
+	_lastMicros = nowMicros;
+	do
+	{
+		uint8_t value = delta & 0x7F;
+		delta >>= 7;
+		_buffer[_length++] = value | (delta ? 0x80 : 0);
+	} while (delta != 0);
+}
+
+void RV3032TraceRecorder::mark(uint8_t tag, uint32_t nowMicros)
+{
+	if (_open == true || reserve(RV3032_TRACE_MAX_HEADER) == false)
+	{
+		_dropped++;
+		return;
+	}
+	_buffer[_length++] = RV3032_TRACE_MARKER;
+	putDelta(nowMicros);
+	_buffer[_length++] = tag;
+}
+
+void RV3032TraceRecorder::beginTransaction(uint8_t address, bool read, uint8_t length, uint32_t nowMicros)
+{
+	if (length > RV3032_TRACE_MAX_DATA)
+		length = RV3032_TRACE_MAX_DATA;
+	if (_open == true || reserve(RV3032_TRACE_MAX_HEADER + length) == false)
+	{
+		_open = false;
+		_dropped++;
+		return;
+	}
+	_buffer[_length++] = (read ? 0x80 : 0) | (address & 0x7F);
+	putDelta(nowMicros);
+	_lengthSlot = _length++;
+	_buffer[_lengthSlot] = length;
+	_remaining = length;
+	_open = true;
+}
+
+void RV3032TraceRecorder::add(const uint8_t * data, uint8_t len)
+{
+	if (_open == false || len == 0)
+		return;
+	if (len > _remaining)
+		len = _remaining;
+	memcpy(_buffer + _length, data, len);
+	_length += len;
+	_remaining -= len;
+}
+
+void RV3032TraceRecorder::endTransaction(bool ack)
+{
+	if (_open == false)
+		return;
+	_buffer[_lengthSlot] -= _remaining; //Whatever add() didn't fill
+	if (ack == false)
+		_buffer[_lengthSlot] |= 0x80;
+	_open = false;
+	_transactions++;
+}
+
+const uint8_t * RV3032TraceRecorder::getData()
+{
+	return _buffer;
+}
+
+uint16_t RV3032TraceRecorder::getLength()
+{
+	return _length;
+}
+
+uint32_t RV3032TraceRecorder::getTransactions()
+{
+	return _transactions;
+}
+
+uint32_t RV3032TraceRecorder::getDropped()
+{
+	return _dropped;
+}
+
+RV3032TraceReader::RV3032TraceReader(const uint8_t * trace, size_t len)
+{
+	_trace = trace;
+	_len = len;
+	rewind();
+}
+
+void RV3032TraceReader::rewind()
+{
+	_position = 0;
+	_time = 0;
+	_truncated = false;
+	if (_len >= RV3032_TRACE_MAGIC_LENGTH && memcmp(_trace, RV3032_TRACE_MAGIC, RV3032_TRACE_MAGIC_LENGTH) == 0)
+		_position = RV3032_TRACE_MAGIC_LENGTH;
+}
+
+bool RV3032TraceReader::isTruncated()
+{
+	return _truncated;
+}
+
+bool RV3032TraceReader::next(RV3032TraceRecord &record)
+{
+	if (_position >= _len)
+		return false;
+
+	size_t position = _position;
+	uint8_t type = _trace[position++];
+
+	uint32_t delta = 0;
+	for (uint8_t shift = 0; ; shift += 7)
+	{
+		if (position >= _len || shift > 28)
+		{
+			_truncated = true;
+			return false;
+		}
+		uint8_t value = _trace[position++];
+		delta |= (uint32_t)(value & 0x7F) << shift;
+		if ((value & 0x80) == 0)
+			break;
+	}
+
+	if (position >= _len)
+	{
+		_truncated = true;
+		return false;
+	}
+
+	record.marker = (type == RV3032_TRACE_MARKER);
+	record.address = type & 0x7F;
+	record.read = (type & 0x80) != 0;
+	if (record.marker == true)
+	{
+		record.tag = _trace[position++];
+		record.ack = true;
+		record.length = 0;
+		record.data = NULL;
+	}
+	else
+	{
+		uint8_t length = _trace[position++];
+		record.tag = 0;
+		record.ack = (length & 0x80) == 0;
+		record.length = length & 0x7F;
+		record.data = _trace + position;
+		if (position + record.length > _len)
+		{
+			_truncated = true;
+			return false;
+		}
+		position += record.length;
+	}
+
+	_time += delta;
+	record.time = _time;
+	_position = position;
+	return true;
+}
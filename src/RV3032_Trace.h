@@ -0,0 +1,114 @@
+/******************************************************************************
+RV3032_Trace.h
+RV3032 Arduino Library
+
+Bus traffic recording. Attach an RV3032TraceRecorder with setTraceRecorder() and the
+register primitives log every transaction into a caller supplied buffer; when it fills,
+the flush callback (if any) gets the bytes so they can go to SD, flash or Serial, and
+recording carries on. extras/host/rv3032_replay summarises traces, compares two of them
+and replays one against the current library. Nothing in here depends on Arduino.
+
+Trace format, starting with the 4 byte magic "RVT1":
+  Transaction  [R/W:1 | address:7] [microseconds since the previous record, LEB128]
+               [NACK:1 | length:7] [length data bytes]
+  Marker       [0x7F] [microseconds since the previous record, LEB128] [tag]
+R/W is 1 for reads. A write's data starts with the register pointer, an empty write is
+the address probe in begin(). 0x7F is a reserved
+I2C address, so it can't clash with a transaction. Markers are written by mark(): tag the
+start of each API call to get per call numbers from the replayer, the TRACE_TAG values
+below can also be replayed.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define RV3032_TRACE_MAGIC                 "RVT1"
+#define RV3032_TRACE_MAGIC_LENGTH          4
+#define RV3032_TRACE_MARKER                0x7F
+#define RV3032_TRACE_MAX_DATA              0x7F
+#define RV3032_TRACE_MAX_HEADER            7 // Type, 5 byte delta and length
+
+//Tags the replayer knows how to drive. 0x80 and up are free for the application
+#define TRACE_TAG_BEGIN                    0x01 // begin()
+#define TRACE_TAG_UPDATE_TIME              0x02 // updateTime()
+#define TRACE_TAG_CLEAR_FLAGS              0x03 // clearAllInterruptFlags()
+#define TRACE_TAG_DRAIN_EVI                0x04 // drainEVIEvents()
+#define TRACE_TAG_TIMESTAMP                0x05 // stringTimestamp()
+#define TRACE_TAG_CALIBRATION              0x06 // getCalibrationOffsetSteps()
+#define TRACE_TAG_SAVE_CONFIG              0x07 // saveConfig()
+#define TRACE_TAG_USER                     0x80
+
+class RV3032TraceRecorder
+{
+public:
+
+	//flush is called with the full buffer (and from flush()), without one recording stops when the buffer is full
+	RV3032TraceRecorder(uint8_t * buffer, uint16_t size, void (*flush)(const uint8_t * data, uint16_t len) = NULL);
+
+	void clear(); //Empties the buffer and writes the magic
+	void flush(); //Hands what is buffered to the flush callback
+
+	void mark(uint8_t tag, uint32_t nowMicros);
+
+	//Called by the I/O primitives: beginTransaction() with the total length, add() until it is reached, endTransaction()
+	void beginTransaction(uint8_t address, bool read, uint8_t length, uint32_t nowMicros);
+	void add(const uint8_t * data, uint8_t len);
+	void endTransaction(bool ack);
+
+	const uint8_t * getData();
+	uint16_t getLength();
+	uint32_t getTransactions();
+	uint32_t getDropped(); //Transactions and markers lost to a full buffer
+
+  private:
+	bool reserve(uint16_t len);
+	void putDelta(uint32_t nowMicros);
+
+	uint8_t * _buffer;
+	uint16_t _size;
+	void (*_flush)(const uint8_t * data, uint16_t len);
+	uint16_t _length = 0;
+	uint16_t _lengthSlot = 0; //Where the length byte of the open transaction goes
+	uint8_t _remaining = 0; //Data bytes the open transaction still has room for
+	bool _open = false;
+	bool _primed = false;
+	uint32_t _lastMicros = 0;
+	uint32_t _transactions = 0;
+	uint32_t _dropped = 0;
+};
+
+//One decoded record. time is microseconds since the first record
+struct RV3032TraceRecord
+{
+	uint64_t time;
+	bool marker;
+	uint8_t tag; //Markers only
+	uint8_t address;
+	bool read;
+	bool ack;
+	uint8_t length;
+	const uint8_t * data; //Points into the trace
+};
+
+class RV3032TraceReader
+{
+public:
+
+	RV3032TraceReader(const uint8_t * trace, size_t len); //With or without the magic, flushed chunks can be concatenated
+
+	bool next(RV3032TraceRecord &record); //false at the end or on a truncated record
+	bool isTruncated(); //Stopped in the middle of a record
+	void rewind();
+
+  private:
+	const uint8_t * _trace;
+	size_t _len;
+	size_t _position = 0;
+	uint64_t _time = 0;
+	bool _truncated = false;
+};
@@ -0,0 +1,1014 @@
+/******************************************************************************
+RV_ClockCore.cpp
+RV3032 Arduino Library
+
+Originally written for RV-8803-C7 by:
+Andy England @ SparkFun Electronics
+https://github.com/sparkfun/SparkFun_RV-8803_Arduino_Library
+
+Modified by Cole Kindall for use with RV-3032-C7
+March 26, 2021
+
+Shared by both chips since the chip traits rework, see RV_ClockCore.h.
+The template is instantiated for RV3032Traits and RV8803Traits at the bottom of this file;
+functions a sketch doesn't call are dropped by the linker as usual.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example. If you have any questions
+or concerns with licensing, please contact techsupport@sparkfun.com.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "SparkFun_RV3032.h"
+#include "SparkFun_RV8803.h"
+
+//****************************************************************************//
+//
+//  Settings and configuration
+//
+//****************************************************************************//
+
+// Parse the __DATE__ predefined macro to generate date defaults:
+// __Date__ Format: MMM DD YYYY (First D may be a space if <10)
+// <MONTH>
+#define BUILD_MONTH_JAN ((__DATE__[0] == 'J') && (__DATE__[1] == 'a')) ? 1 : 0
+#define BUILD_MONTH_FEB (__DATE__[0] == 'F') ? 2 : 0
+#define BUILD_MONTH_MAR ((__DATE__[0] == 'M') && (__DATE__[1] == 'a') && (__DATE__[2] == 'r')) ? 3 : 0
+#define BUILD_MONTH_APR ((__DATE__[0] == 'A') && (__DATE__[1] == 'p')) ? 4 : 0
+#define BUILD_MONTH_MAY ((__DATE__[0] == 'M') && (__DATE__[1] == 'a') && (__DATE__[2] == 'y')) ? 5 : 0
+#define BUILD_MONTH_JUN ((__DATE__[0] == 'J') && (__DATE__[1] == 'u') && (__DATE__[2] == 'n')) ? 6 : 0
+#define BUILD_MONTH_JUL ((__DATE__[0] == 'J') && (__DATE__[1] == 'u') && (__DATE__[2] == 'l')) ? 7 : 0
+#define BUILD_MONTH_AUG ((__DATE__[0] == 'A') && (__DATE__[1] == 'u')) ? 8 : 0
+#define BUILD_MONTH_SEP (__DATE__[0] == 'S') ? 9 : 0
+#define BUILD_MONTH_OCT (__DATE__[0] == 'O') ? 10 : 0
+#define BUILD_MONTH_NOV (__DATE__[0] == 'N') ? 11 : 0
+#define BUILD_MONTH_DEC (__DATE__[0] == 'D') ? 12 : 0
+#define BUILD_MONTH BUILD_MONTH_JAN | BUILD_MONTH_FEB | BUILD_MONTH_MAR | \
+BUILD_MONTH_APR | BUILD_MONTH_MAY | BUILD_MONTH_JUN | \
+BUILD_MONTH_JUL | BUILD_MONTH_AUG | BUILD_MONTH_SEP | \
+BUILD_MONTH_OCT | BUILD_MONTH_NOV | BUILD_MONTH_DEC
+// <DATE>
+#define BUILD_DATE_0 ((__DATE__[4] == ' ') ? 0 : (__DATE__[4] - 0x30))
+#define BUILD_DATE_1 (__DATE__[5] - 0x30)
+#define BUILD_DATE ((BUILD_DATE_0 * 10) + BUILD_DATE_1)
+// <YEAR>
+#define BUILD_YEAR (((__DATE__[7] - 0x30) * 1000) + ((__DATE__[8] - 0x30) * 100) + \
+((__DATE__[9] - 0x30) * 10)  + ((__DATE__[10] - 0x30) * 1))
+
+// Parse the __TIME__ predefined macro to generate time defaults:
+// __TIME__ Format: HH:MM:SS (First number of each is padded by 0 if <10)
+// <HOUR>
+#define BUILD_HOUR_0 ((__TIME__[0] == ' ') ? 0 : (__TIME__[0] - 0x30))
+#define BUILD_HOUR_1 (__TIME__[1] - 0x30)
+#define BUILD_HOUR ((BUILD_HOUR_0 * 10) + BUILD_HOUR_1)
+// <MINUTE>
+#define BUILD_MINUTE_0 ((__TIME__[3] == ' ') ? 0 : (__TIME__[3] - 0x30))
+#define BUILD_MINUTE_1 (__TIME__[4] - 0x30)
+#define BUILD_MINUTE ((BUILD_MINUTE_0 * 10) + BUILD_MINUTE_1)
+// <SECOND>
+#define BUILD_SECOND_0 ((__TIME__[6] == ' ') ? 0 : (__TIME__[6] - 0x30))
+#define BUILD_SECOND_1 (__TIME__[7] - 0x30)
+#define BUILD_SECOND ((BUILD_SECOND_0 * 10) + BUILD_SECOND_1)
+template <class Chip>
+bool RVClockCore<Chip>::begin(TwoWire &wirePort)
+{
+	_i2cPort = &wirePort;
+	
+	uint32_t start = traceStart();
+	_i2cPort->beginTransmission(Chip::ADDRESS);
+	countTransaction(0);
+	
+	bool ack = (_i2cPort->endTransmission() == 0);
+	traceTransaction(start, false, NULL, NULL, 0, ack);
+	if (ack == false)
+	{
+		return (false); //Error: Sensor did not ack
+	}
+	return(true);
+}
+
+//Configures the microcontroller to convert to 12 hour mode.
+template <class Chip>
+void RVClockCore<Chip>::set12Hour()
+{
+	_isTwelveHour = TWELVE_HOUR_MODE;
+}
+
+//Configures the microcontroller to not convert from the default 24 hour mode.
+template <class Chip>
+void RVClockCore<Chip>::set24Hour()
+{
+	_isTwelveHour = TWENTYFOUR_HOUR_MODE;
+}
+
+//Returns true if the microcontroller has been configured for 12 hour mode
+template <class Chip>
+bool RVClockCore<Chip>::is12Hour()
+{
+	return _isTwelveHour;
+}
+
+//Returns true if the microcontroller is in 12 hour mode and the RTC has an hours value greater than or equal to 12 (Noon).
+template <class Chip>
+bool RVClockCore<Chip>::isPM()
+{
+	refreshTime();
+	if (is12Hour())
+	{
+		return BCDtoDEC(_time[TIME_HOURS]) >= 12;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+#if RV3032_ENABLE_FORMATTING
+//Writes a zero padded two digit number, used instead of sprintf to keep printf out of the build
+static char* printTwoDigits(char *dest, uint8_t value)
+{
+	dest[0] = '0' + value / 10;
+	dest[1] = '0' + value % 10;
+	return dest + 2;
+}
+
+//Writes first, second and third separated by separator, the last one being 20yy. Used for the date strings
+static char* printDate(char *dest, uint8_t first, uint8_t second, uint8_t year, char separator)
+{
+	dest = printTwoDigits(dest, first);
+	*dest++ = separator;
+	dest = printTwoDigits(dest, second);
+	*dest++ = separator;
+	*dest++ = '2';
+	*dest++ = '0';
+	dest = printTwoDigits(dest, year);
+	*dest = '\0';
+	return dest;
+}
+
+//Writes hh:mm:ss, converting hours to 12 hour format when twelveHour is set. Returns where AM/PM goes
+static char* printClock(char *dest, uint8_t hours, uint8_t minutes, uint8_t seconds, bool twelveHour)
+{
+	if (twelveHour && hours > 12)
+	{
+		hours -= 12;
+	}
+	dest = printTwoDigits(dest, hours);
+	*dest++ = ':';
+	dest = printTwoDigits(dest, minutes);
+	*dest++ = ':';
+	dest = printTwoDigits(dest, seconds);
+	*dest = '\0';
+	return dest;
+}
+
+static void printHalf(char *dest, bool pm)
+{
+	dest[0] = pm ? 'P' : 'A';
+	dest[1] = 'M';
+	dest[2] = '\0';
+}
+
+//Returns the date in MM/DD/YYYY format.
+template <class Chip>
+char* RVClockCore<Chip>::stringDateUSA()
+{
+	static char date[11]; //Max of mm/dd/yyyy with \0 terminator
+	refreshTime();
+	printDate(date, BCDtoDEC(_time[TIME_MONTH]), BCDtoDEC(_time[TIME_DATE]), BCDtoDEC(_time[TIME_YEAR]), '/');
+	return(date);
+}
+
+//Returns the date in the DD/MM/YYYY format.
+template <class Chip>
+char* RVClockCore<Chip>::stringDate()
+{
+	static char date[11]; //Max of dd/mm/yyyy with \0 terminator
+	refreshTime();
+	printDate(date, BCDtoDEC(_time[TIME_DATE]), BCDtoDEC(_time[TIME_MONTH]), BCDtoDEC(_time[TIME_YEAR]), '/');
+	return(date);
+}
+
+//Returns the time in hh:mm:ss (Adds AM/PM if in 12 hour mode).
+template <class Chip>
+char* RVClockCore<Chip>::stringTime()
+{
+	static char time[11]; //Max of hh:mm:ssXM with \0 terminator
+	holdTime(); //isPM() has to see the same reading
+
+	char *end = printClock(time, BCDtoDEC(_time[TIME_HOURS]), BCDtoDEC(_time[TIME_MINUTES]), BCDtoDEC(_time[TIME_SECONDS]), is12Hour());
+	if(is12Hour() == true)
+	{
+		printHalf(end, isPM());
+	}
+	
+	releaseTime();
+	return(time);
+}
+
+//Returns the most recent timestamp captured on the EVI pin (if the EVI pin has been configured to capture events)
+//The RV-3032 captures up to the year, the RV-8803 only hundredths and seconds: its minutes and hours come
+//from the last updateTime(), so read the timestamp in the minute the event happened
+template <class Chip>
+char* RVClockCore<Chip>::stringTimestamp()
+{
+	static char time[14]; //Max of hh:mm:ss:HHXM with \0 terminator
+	refreshTime();
+
+	uint8_t capture[4]; //Hundredths, seconds, minutes and hours in one burst
+	memcpy(capture, _time, sizeof(capture));
+	readMultipleRegisters(Chip::CAPTURE_REG, capture, Chip::CAPTURE_FIELDS < sizeof(capture) ? Chip::CAPTURE_FIELDS : sizeof(capture));
+	uint8_t hours = BCDtoDEC(capture[3] & 0x3F);
+
+	char *end = printClock(time, hours, BCDtoDEC(capture[2] & 0x7F), BCDtoDEC(capture[1] & 0x7F), is12Hour());
+	*end++ = ':';
+	end = printTwoDigits(end, BCDtoDEC(capture[0]));
+	*end = '\0';
+	if(is12Hour() == true)
+	{
+		printHalf(end, hours >= 12);
+	}
+	
+	return(time);
+}
+
+//Returns timestamp in ISO 8601 format (yyyy-mm-ddThh:mm:ss).
+template <class Chip>
+char* RVClockCore<Chip>::stringTime8601()
+{
+	static char timeStamp[21]; //Max of yyyy-mm-ddThh:mm:ss with \0 terminator
+	refreshTime();
+
+	char *end = timeStamp;
+	*end++ = '2';
+	*end++ = '0';
+	end = printTwoDigits(end, BCDtoDEC(_time[TIME_YEAR]));
+	*end++ = '-';
+	end = printTwoDigits(end, BCDtoDEC(_time[TIME_MONTH]));
+	*end++ = '-';
+	end = printTwoDigits(end, BCDtoDEC(_time[TIME_DATE]));
+	*end++ = 'T';
+	printClock(end, BCDtoDEC(_time[TIME_HOURS]), BCDtoDEC(_time[TIME_MINUTES]), BCDtoDEC(_time[TIME_SECONDS]), false);
+	
+	return(timeStamp);
+}
+#endif
+
+#if RV3032_ENABLE_EPOCH
+//Returns time in UNIX Epoch time format
+//The RTC is treated as UTC, the same way setEpoch() writes it
+template <class Chip>
+uint32_t RVClockCore<Chip>::getEpoch()
+{
+	refreshTime();
+	return rv3032TimeToEpoch(_time);
+}
+
+//Returns the local UNIX time for the RTC time, keeping the RTC itself in UTC
+template <class Chip>
+uint32_t RVClockCore<Chip>::getLocalEpoch(RV3032TimeZone &zone)
+{
+	return zone.utcToLocal(getEpoch());
+}
+#endif
+
+//Returns hundredths of a second since 2000-01-01 00:00:00, straight from the BCD registers
+//Feed it to an RV3032TimeEncoder to log compact binary timestamps instead of strings
+template <class Chip>
+uint64_t RVClockCore<Chip>::getTimestamp()
+{
+	refreshTime();
+	return rv3032TimeToHundredths(_time);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getPackedTimestamp(uint8_t * dest)
+{
+	rv3032Pack40(getTimestamp(), dest);
+	return RV3032_PACKED_LENGTH;
+}
+
+#if RV3032_ENABLE_EPOCH
+//Sets time using UNIX Epoch time
+template <class Chip>
+bool RVClockCore<Chip>::setEpoch(uint32_t value)
+{
+	epochToTime(value);
+	return setTime(_time, TIME_ARRAY_LENGTH);
+}
+
+template <class Chip>
+void RVClockCore<Chip>::epochToTime(uint32_t value)
+{
+	if (value < RV3032_EPOCH_2000) {
+		value = RV3032_EPOCH_2000; // 2000-01-01 00:00:00
+	}
+
+	rv3032EpochToTime(value, _time);
+	_time[TIME_WEEKDAY] = encodeWeekday(_time[TIME_WEEKDAY]);
+}
+#endif
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::encodeWeekday(uint8_t weekday)
+{
+	return Chip::WEEKDAY_ONE_HOT ? 1 << weekday : weekday;
+}
+
+//Set time and date/day registers of the RTC
+template <class Chip>
+bool RVClockCore<Chip>::setTime(uint8_t sec, uint8_t min, uint8_t hour, uint8_t weekday, uint8_t date, uint8_t month, uint16_t year)
+{
+	_time[TIME_SECONDS] = DECtoBCD(sec);
+	_time[TIME_MINUTES] = DECtoBCD(min);
+	_time[TIME_HOURS] = DECtoBCD(hour);
+	_time[TIME_DATE] = DECtoBCD(date);
+	_time[TIME_WEEKDAY] = encodeWeekday(weekday);
+	_time[TIME_MONTH] = DECtoBCD(month);
+	_time[TIME_YEAR] = DECtoBCD(year - 2000);
+		
+	return setTime(_time, TIME_ARRAY_LENGTH);
+}
+
+//Set time and date/day registers of the RTC (using data array)
+template <class Chip>
+bool RVClockCore<Chip>::setTime(uint8_t * time, uint8_t len)
+{
+	if (len != TIME_ARRAY_LENGTH)
+		return false;
+	
+	return writeMultipleRegisters(Chip::TIME_REG + 1, time + 1, len - 1); //We use length - 1 as that is the length without the read-only hundredths register. We also point to the second element in the time array as hundredths is read only
+}
+
+//Setting and clearing the hold bit (STOP on the RV-3032, RESET on the RV-8803) clears the prescaler
+template <class Chip>
+bool RVClockCore<Chip>::setHundredthsToZero()
+{
+	uint8_t control = readRegister(Chip::INTERRUPT_REG);
+	bool temp = writeRegister(Chip::INTERRUPT_REG, control | (1 << Chip::HOLD_BIT));
+	temp &= writeRegister(Chip::INTERRUPT_REG, control & ~(1 << Chip::HOLD_BIT));
+	return temp;
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setSeconds(uint8_t value)
+{
+	_time[TIME_SECONDS] = DECtoBCD(value);
+	return setTime(_time, TIME_ARRAY_LENGTH);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setMinutes(uint8_t value)
+{
+	_time[TIME_MINUTES] = DECtoBCD(value);
+	return setTime(_time, TIME_ARRAY_LENGTH);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setHours(uint8_t value)
+{
+	_time[TIME_HOURS] = DECtoBCD(value);
+	return setTime(_time, TIME_ARRAY_LENGTH);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setDate(uint8_t value)
+{
+	_time[TIME_DATE] = DECtoBCD(value);
+	return setTime(_time, TIME_ARRAY_LENGTH);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setMonth(uint8_t value)
+{
+	_time[TIME_MONTH] = DECtoBCD(value);
+	return setTime(_time, TIME_ARRAY_LENGTH);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setYear(uint16_t value)
+{
+	_time[TIME_YEAR] = DECtoBCD(value - 2000);
+	return setTime(_time, TIME_ARRAY_LENGTH);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setWeekday(uint8_t value) //value is anywhere between 0=sunday and 6=saturday
+{
+	if (value > 6)
+	{
+		value = 6;
+	}
+	_time[TIME_WEEKDAY] = encodeWeekday(value);
+	return setTime(_time, TIME_ARRAY_LENGTH);
+}
+
+//Move the hours, mins, sec, etc registers from the RTC into the _time array
+//Needs to be called before printing time or date
+template <class Chip>
+bool RVClockCore<Chip>::updateTime()
+{
+	_timeUpdated = false; //Before the read, so an update that comes in during it is not lost
+	uint8_t time[TIME_ARRAY_LENGTH];
+	if (readMultipleRegisters(Chip::TIME_REG, time, TIME_ARRAY_LENGTH) == false)
+		return(false); //Something went wrong
+	return commitTime(time);
+}
+
+//Takes a time just read from the RTC as the local copy. Nothing changes if the second read fails
+template <class Chip>
+bool RVClockCore<Chip>::commitTime(uint8_t * time)
+{
+	if (BCDtoDEC(time[TIME_SECONDS]) == 59) //If seconds are at 59, read again to make sure we didn't accidentally skip a minute
+	{	
+		uint8_t tempTime[TIME_ARRAY_LENGTH];
+		if (readMultipleRegisters(Chip::TIME_REG, tempTime, TIME_ARRAY_LENGTH) == false)
+		{
+			return(false); //Something went wrong
+		}
+		if (BCDtoDEC(tempTime[TIME_SECONDS]) == 0) //If the reading for seconds changed, then our new data is correct, otherwise, we can leave the old data.
+		{
+			memcpy(time, tempTime, TIME_ARRAY_LENGTH);
+		}
+	}
+	memcpy(_time, time, TIME_ARRAY_LENGTH);
+	_timeMillis = millis();
+	_timeRead = true;
+	return true;
+}
+
+template <class Chip>
+void RVClockCore<Chip>::setTimeMaxAge(uint16_t maxAgeMs)
+{
+	_timeMaxAge = maxAgeMs;
+}
+
+template <class Chip>
+uint16_t RVClockCore<Chip>::getTimeMaxAge()
+{
+	return _timeMaxAge;
+}
+
+template <class Chip>
+void RVClockCore<Chip>::notifyTimeUpdate()
+{
+	_timeUpdated = true;
+}
+
+template <class Chip>
+uint32_t RVClockCore<Chip>::getTimeAge()
+{
+	return (uint32_t)(millis() - _timeMillis);
+}
+
+template <class Chip>
+void RVClockCore<Chip>::holdTime()
+{
+	refreshTime();
+	if (_timeHolds < 0xFF)
+		_timeHolds++;
+}
+
+template <class Chip>
+void RVClockCore<Chip>::releaseTime()
+{
+	if (_timeHolds > 0)
+		_timeHolds--;
+}
+
+//A failed read leaves the old copy, and the next getter tries again
+template <class Chip>
+void RVClockCore<Chip>::refreshTime()
+{
+	if (_timeMaxAge == RV3032_TIME_MANUAL || _timeHolds > 0)
+		return;
+	if (_timeRead == true && _timeUpdated == false && (uint32_t)(millis() - _timeMillis) < _timeMaxAge)
+		return;
+	updateTime();
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getHundredths()
+{
+	refreshTime();
+	return BCDtoDEC(_time[TIME_HUNDREDTHS]);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getSeconds()
+{
+	refreshTime();
+	return BCDtoDEC(_time[TIME_SECONDS]);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getMinutes()
+{
+	refreshTime();
+	return BCDtoDEC(_time[TIME_MINUTES]);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getHours()
+{
+	refreshTime();
+	uint8_t tempHours = BCDtoDEC(_time[TIME_HOURS]);
+	if (is12Hour())
+	{
+		if (tempHours > 12)
+		{
+			tempHours -= 12;
+		}
+	}
+	return tempHours;
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getDate()
+{
+	refreshTime();
+	return BCDtoDEC(_time[TIME_DATE]);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getWeekday()
+{
+	refreshTime();
+	if (Chip::WEEKDAY_ONE_HOT == false)
+	{
+		return _time[TIME_WEEKDAY] & 0x07;
+	}
+	uint8_t tempWeekday = 0;
+	while ((_time[TIME_WEEKDAY] >> (tempWeekday + 1)) != 0) //Position of the highest set bit, no need for log()
+	{
+		tempWeekday++;
+	}
+	return tempWeekday;
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getMonth()
+{
+	refreshTime();
+	return BCDtoDEC(_time[TIME_MONTH]);
+}
+
+template <class Chip>
+uint16_t RVClockCore<Chip>::getYear()
+{
+	refreshTime();
+	return BCDtoDEC(_time[TIME_YEAR]) + 2000;
+}
+
+//Takes the time from the last build and uses it as the current time
+//Works very well as an arduino sketch
+template <class Chip>
+bool RVClockCore<Chip>::setToCompilerTime()
+{
+	_time[TIME_SECONDS] = DECtoBCD(BUILD_SECOND);
+	_time[TIME_MINUTES] = DECtoBCD(BUILD_MINUTE);
+	_time[TIME_HOURS] = DECtoBCD(BUILD_HOUR);
+	
+	_time[TIME_MONTH] = DECtoBCD(BUILD_MONTH);
+	_time[TIME_DATE] = DECtoBCD(BUILD_DATE);
+	_time[TIME_YEAR] = DECtoBCD(BUILD_YEAR - 2000); //! Not Y2K (or Y2.1K)-proof :(
+	
+	// Calculate weekday (from here: http://stackoverflow.com/a/21235587)
+	// 0 = Sunday, 6 = Saturday
+	uint16_t d = BUILD_DATE;
+	uint16_t m = BUILD_MONTH;
+	uint16_t y = BUILD_YEAR;
+	uint16_t weekday = (d+=m<3?y--:y-2,23*m/9+d+4+y/4-y/100+y/400)%7;
+	_time[TIME_WEEKDAY] = encodeWeekday(weekday);
+	
+	return setTime(_time, TIME_ARRAY_LENGTH);
+}
+
+#if RV3032_ENABLE_EEPROM
+//Offset in steps of Chip::OFFSET_STEP_TENTH_PPB, -32 to 31. Other bits sharing the register are kept
+template <class Chip>
+bool RVClockCore<Chip>::setCalibrationOffsetSteps(int8_t steps)
+{
+	if (steps < -32)
+		steps = -32;
+	if (steps > 31)
+		steps = 31;
+
+	uint8_t value = readRegister(Chip::OFFSET_REG);
+	value &= ~(0b00111111);
+	value |= steps & 0b00111111; //6 bit two's complement
+	return writeRegister(Chip::OFFSET_REG, value);
+}
+
+template <class Chip>
+int8_t RVClockCore<Chip>::getCalibrationOffsetSteps()
+{
+	int8_t value = readRegister(Chip::OFFSET_REG) & 0b00111111;
+	if (value >= 32)
+	{
+		value -= 64;
+	}
+	return value;
+}
+
+#if RV3032_ENABLE_FLOAT
+template <class Chip>
+bool RVClockCore<Chip>::setCalibrationOffset(float ppm)
+{
+	float steps = ppm * 10000 / Chip::OFFSET_STEP_TENTH_PPB;
+	return setCalibrationOffsetSteps(steps < -32 ? -32 : steps > 31 ? 31 : (int8_t)steps);
+}
+
+template <class Chip>
+float RVClockCore<Chip>::getCalibrationOffset()
+{
+	return getCalibrationOffsetSteps() * (Chip::OFFSET_STEP_TENTH_PPB / 10000.0);
+}
+#endif
+
+template <class Chip>
+bool RVClockCore<Chip>::setClockOutTimerFrequency(uint8_t clockOutTimerFrequency)
+{
+	return writeBit(Chip::CLKOUT_REG, Chip::CLKOUT_BIT, clockOutTimerFrequency);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getClockOutTimerFrequency()
+{
+	return readTwoBits(Chip::CLKOUT_REG, Chip::CLKOUT_BIT);
+}
+#endif
+
+#if RV3032_ENABLE_EVI
+template <class Chip>
+uint8_t RVClockCore<Chip>::getHundredthsCapture()
+{
+	return BCDtoDEC(readRegister(Chip::CAPTURE_REG));
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getSecondsCapture()
+{
+	return BCDtoDEC(readRegister(Chip::CAPTURE_REG + TIME_SECONDS) & 0x7F);
+}
+
+//With calibration on, an EVI event zeroes the hundredths (ESYN on the RV-3032, ERST on the RV-8803)
+template <class Chip>
+bool RVClockCore<Chip>::setEVICalibration(bool eviCalibration)
+{
+	return writeBit(Chip::EVI_CONTROL_REG, Chip::EVI_SYNC_BIT, eviCalibration);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setEVIDebounceTime(uint8_t debounceTime)
+{
+	return writeBit(Chip::EVI_CONTROL_REG, Chip::EVI_FILTER_BIT, debounceTime);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setEVIEdgeDetection(bool edge)
+{
+	return writeBit(Chip::EVI_CONTROL_REG, Chip::EVI_EDGE_BIT, edge);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getEVIDebounceTime()
+{
+	return readTwoBits(Chip::EVI_CONTROL_REG, Chip::EVI_FILTER_BIT);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::getEVICalibration()
+{
+	return readBit(Chip::EVI_CONTROL_REG, Chip::EVI_SYNC_BIT);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::getEVIEdgeDetection()
+{
+	return readBit(Chip::EVI_CONTROL_REG, Chip::EVI_EDGE_BIT);
+}
+#endif
+
+#if RV3032_ENABLE_INTERRUPTS
+template <class Chip>
+bool RVClockCore<Chip>::setCountdownTimerEnable(bool timerState)
+{
+	return writeBit(Chip::TIMER_CONTROL_REG, Chip::TIMER_ENABLE_BIT, timerState);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setCountdownTimerFrequency(uint8_t countdownTimerFrequency)
+{
+	return writeBit(Chip::TIMER_CONTROL_REG, Chip::TIMER_FREQUENCY_BIT, countdownTimerFrequency);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setCountdownTimerClockTicks(uint16_t clockTicks)
+{
+	//First handle the upper bit, as we need to preserve the GPX bits
+	uint8_t value = readRegister(Chip::TIMER_REG + 1);
+	value &= (0<<8); //Clear the least significant nibble
+	value |= (clockTicks >> 8);
+	bool returnValue = writeRegister(Chip::TIMER_REG + 1, value);
+	value = clockTicks & 0x00FF;
+	returnValue &= writeRegister(Chip::TIMER_REG, value);
+	return returnValue;
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::getCountdownTimerEnable()
+{
+	return readBit(Chip::TIMER_CONTROL_REG, Chip::TIMER_ENABLE_BIT);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getCountdownTimerFrequency()
+{
+	return readTwoBits(Chip::TIMER_CONTROL_REG, Chip::TIMER_FREQUENCY_BIT);
+}
+
+template <class Chip>
+uint16_t RVClockCore<Chip>::getCountdownTimerClockTicks()
+{
+	uint16_t value = readRegister(Chip::TIMER_REG + 1) << 8;
+	value |= readRegister(Chip::TIMER_REG);
+	return value;
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setPeriodicTimeUpdateFrequency(bool timeUpdateFrequency)
+{
+		return writeBit(Chip::TIMER_CONTROL_REG, Chip::UPDATE_SELECT_BIT, timeUpdateFrequency);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::getPeriodicTimeUpdateFrequency()
+{	
+	return readBit(Chip::TIMER_CONTROL_REG, Chip::UPDATE_SELECT_BIT);
+}
+
+/********************************
+Set Alarm Mode controls which parts of the time have to match for the alarm to trigger.
+When the RTC matches a given time, make an interrupt fire.
+Setting a bit to 1 means that the RTC does not check if that value matches to trigger the alarm
+********************************/
+template <class Chip>
+void RVClockCore<Chip>::setItemsToMatchForAlarm(bool minuteAlarm, bool hourAlarm, bool dateAlarm)
+{
+	writeBit(Chip::ALARM_REG, ALARM_ENABLE, !minuteAlarm); //For some reason these bits are active low
+	writeBit(Chip::ALARM_REG + 1, ALARM_ENABLE, !hourAlarm);
+	writeBit(Chip::ALARM_REG + 2, ALARM_ENABLE, !dateAlarm);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setAlarmMinutes(uint8_t minute)
+{
+	uint8_t value = readRegister(Chip::ALARM_REG);
+	value &= (1 << ALARM_ENABLE); //clear everything but enable bit
+	value |= DECtoBCD(minute);
+	return writeRegister(Chip::ALARM_REG, value);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::setAlarmHours(uint8_t hour)
+{
+	uint8_t value = readRegister(Chip::ALARM_REG + 1);
+	value &= (1 << ALARM_ENABLE); //clear everything but enable bit
+	value |= DECtoBCD(hour);
+	return writeRegister(Chip::ALARM_REG + 1, value);
+}
+
+//On chips where the register doubles as a weekday alarm, this also selects the date alarm
+template <class Chip>
+bool RVClockCore<Chip>::setAlarmDate(uint8_t date)
+{
+	bool returnValue = true;
+	if (Chip::WEEKDAY_ALARM)
+	{
+		returnValue &= writeBit(Chip::ALARM_SELECT_REG, Chip::ALARM_SELECT_BIT, true);
+	}
+	uint8_t value = readRegister(Chip::ALARM_REG + 2);
+	value &= (1 << ALARM_ENABLE); //clear everything but enable bit
+	value |= DECtoBCD(date);
+	returnValue &= writeRegister(Chip::ALARM_REG + 2, value);
+	return returnValue;
+}
+
+#if RV3032_ENABLE_EPOCH
+/*********************************
+Program the alarm for the next time the local clock reads hour:minute while the RTC keeps UTC.
+The UTC equivalent depends on the offset in effect on that day, so call this again after
+the alarm fires to re-arm it across DST changes.
+*********************************/
+template <class Chip>
+bool RVClockCore<Chip>::setAlarmLocal(uint8_t hour, uint8_t minute, RV3032TimeZone &zone)
+{
+	uint32_t local = getLocalEpoch(zone);
+	uint32_t target = local - (local % 86400UL) + hour * 3600UL + minute * 60UL;
+	if (target <= local)
+	{
+		target += 86400UL;
+	}
+
+	uint32_t utc = zone.localToUtc(target);
+	uint8_t year, month, date;
+	rv3032DateFromDays((utc - RV3032_EPOCH_2000) / 86400UL, year, month, date);
+
+	bool returnValue = setAlarmMinutes((utc / 60) % 60);
+	returnValue &= setAlarmHours((utc / 3600) % 24);
+	returnValue &= setAlarmDate(date);
+	return returnValue;
+}
+#endif
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getAlarmMinutes()
+{
+	return BCDtoDEC(readRegister(Chip::ALARM_REG) & 0x7F);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getAlarmHours()
+{
+	return BCDtoDEC(readRegister(Chip::ALARM_REG + 1) & 0x7F);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::getAlarmDate()
+{
+	return BCDtoDEC(readRegister(Chip::ALARM_REG + 2) & 0x7F);
+}
+
+/*********************************
+Given a bit location, enable the interrupt
+UPDATE_INTERRUPT 5
+TIMER_INTERRUPT  4
+ALARM_INTERRUPT  3
+EVI_INTERRUPT    2
+*********************************/
+template <class Chip>
+bool RVClockCore<Chip>::enableHardwareInterrupt(uint8_t source)
+{
+	uint8_t value = readRegister(Chip::INTERRUPT_REG);
+	value |= (1<<source); //Set the interrupt enable bit
+	return writeRegister(Chip::INTERRUPT_REG, value);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::disableHardwareInterrupt(uint8_t source)
+{
+	uint8_t value = readRegister(Chip::INTERRUPT_REG);
+	value &= ~(1 << source); //Clear the interrupt enable bit
+	return writeRegister(Chip::INTERRUPT_REG, value);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::disableAllInterrupts()
+{
+	uint8_t value = readRegister(Chip::INTERRUPT_REG);
+	value &= (1 << Chip::HOLD_BIT); //Clear all bits except for STOP/RESET
+	return writeRegister(Chip::INTERRUPT_REG, value);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::getInterruptFlag(uint8_t flagToGet)
+{
+	uint8_t flag = readRegister(Chip::FLAG_REG);
+	flag &= (1 << flagToGet);
+	flag = flag >> flagToGet;
+	return flag;
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::clearAllInterruptFlags() //Read the status register to clear the current interrupt flags
+{
+	return writeRegister(Chip::FLAG_REG, 0b00000000);//Write all 0's to clear all flags
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::clearInterruptFlag(uint8_t flagToClear)
+{
+	uint8_t value = readRegister(Chip::FLAG_REG);
+	value &= ~(1 << flagToClear); //clear flag
+	return writeRegister(Chip::FLAG_REG, value);
+}
+#endif
+
+template <class Chip>
+bool RVClockCore<Chip>::readBit(uint8_t regAddr, uint8_t bitAddr)
+{
+	return ((readRegister(regAddr) & (1 << bitAddr)) >> bitAddr);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::readTwoBits(uint8_t regAddr, uint8_t bitAddr)
+{
+	return ((readRegister(regAddr) & (3 << bitAddr)) >> bitAddr);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::writeBit(uint8_t regAddr, uint8_t bitAddr, bool bitToWrite)
+{
+	uint8_t value = readRegister(regAddr);
+	value &= ~(1 << bitAddr);
+	value |= bitToWrite << bitAddr;
+	return writeRegister(regAddr, value);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::writeBit(uint8_t regAddr, uint8_t bitAddr, uint8_t bitToWrite) //If we see an unsigned 8-bit, we know we have to write two bits.
+{
+	uint8_t value = readRegister(regAddr);
+	value &= ~(3 << bitAddr);
+	value |= bitToWrite << bitAddr;
+	return writeRegister(regAddr, value);
+}
+
+template <class Chip>
+uint8_t RVClockCore<Chip>::readRegister(uint8_t addr)
+{
+	uint8_t value = 0; //Reads as 0 (false) if the sensor does not answer
+	readMultipleRegisters(addr, &value, 1);
+	return value;
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::writeRegister(uint8_t addr, uint8_t val)
+{
+	return writeMultipleRegisters(addr, &val, 1);
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::writeMultipleRegisters(uint8_t addr, uint8_t * values, uint8_t len)
+{
+	uint32_t start = traceStart();
+	_i2cPort->beginTransmission(Chip::ADDRESS);
+	_i2cPort->write(addr);
+	for (uint8_t i = 0; i < len; i++)
+	{
+		_i2cPort->write(values[i]);
+	}
+	countTransaction(len + 1);
+
+	bool ack = (_i2cPort->endTransmission() == 0);
+	traceTransaction(start, false, &addr, values, len, ack);
+	return ack; //false: Sensor did not ack
+}
+
+template <class Chip>
+bool RVClockCore<Chip>::readMultipleRegisters(uint8_t addr, uint8_t * dest, uint8_t len)
+{
+	uint32_t start = traceStart();
+	_i2cPort->beginTransmission(Chip::ADDRESS);
+	_i2cPort->write(addr);
+	countTransaction(1);
+	bool ack = (_i2cPort->endTransmission() == 0);
+	traceTransaction(start, false, &addr, NULL, 0, ack);
+	if (ack == false)
+		return (false); //Error: Sensor did not ack
+
+	start = traceStart();
+	countTransaction(len);
+	//typecasting the len parameter in requestFrom so that the compiler
+	//doesn't give us a warning about multiple candidates
+	uint8_t received = _i2cPort->requestFrom(static_cast<uint8_t>(Chip::ADDRESS), len);
+	for (uint8_t i = 0; i < len; i++)
+	{
+		dest[i] = _i2cPort->read();
+	}
+	traceTransaction(start, true, NULL, dest, len, received == len);
+	
+	return(true);
+}
+
+template <class Chip>
+void RVClockCore<Chip>::setEnergyMeter(RV3032EnergyMeter *meter)
+{
+	_energyMeter = meter;
+}
+
+template <class Chip>
+void RVClockCore<Chip>::traceTransaction(uint32_t start, bool read, const uint8_t * pointer, const uint8_t * data, uint8_t len, bool ack)
+{
+#if RV3032_ENABLE_TRACE
+	if (_traceRecorder == NULL)
+		return;
+	_traceRecorder->beginTransaction(Chip::ADDRESS, read, pointer != NULL ? len + 1 : len, start);
+	if (pointer != NULL)
+		_traceRecorder->add(pointer, 1);
+	_traceRecorder->add(data, len);
+	_traceRecorder->endTransaction(ack);
+#else
+	(void)start; (void)read; (void)pointer; (void)data; (void)len; (void)ack;
+#endif
+}
+
+template <class Chip>
+void RVClockCore<Chip>::setTraceRecorder(RV3032TraceRecorder *recorder)
+{
+	_traceRecorder = recorder;
+}
+
+template class RVClockCore<RV3032Traits>;
+template class RVClockCore<RV8803Traits>;
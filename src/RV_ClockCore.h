@@ -0,0 +1,331 @@
+/******************************************************************************
+RV_ClockCore.h
+RV3032 Arduino Library
+
+Driver code shared by the RV-3032-C7 and the RV-8803-C7. The two chips keep the same
+time, alarm, timer, interrupt and EVI model at different addresses and bit positions,
+so RVClockCore is written once against a chip traits struct (RV3032Traits, RV8803Traits)
+holding those positions as compile time constants. Each chip gets its own copy of the
+code with the constants folded in: no lookups, no virtual calls.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example. If you have any questions
+or concerns with licensing, please contact techsupport@sparkfun.com.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#if (ARDUINO >= 100)
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#include <Wire.h>
+#include "RV3032_Time.h"
+#include "RV3032_TimeZone.h"
+#include "RV3032_Power.h"
+#include "RV3032_Trace.h"
+
+//Feature gates. Set any of these to 0 with a build flag (-DRV3032_ENABLE_FLOAT=0) to leave that part
+//out of the build. Use build flags rather than a #define in the sketch so the library sources see them too.
+#ifndef RV3032_ENABLE_FORMATTING
+#define RV3032_ENABLE_FORMATTING           1 // stringDate(), stringTime()... (no printf either way)
+#endif
+#ifndef RV3032_ENABLE_EPOCH
+#define RV3032_ENABLE_EPOCH                1 // getEpoch(), setEpoch(), syncTo(), time zones
+#endif
+#ifndef RV3032_ENABLE_EEPROM
+#define RV3032_ENABLE_EEPROM               1 // Calibration offset and CLKOUT frequency
+#endif
+#ifndef RV3032_ENABLE_FLOAT
+#define RV3032_ENABLE_FLOAT                1 // Calibration offset in ppm, use the Steps functions to avoid float math
+#endif
+#ifndef RV3032_ENABLE_INTERRUPTS
+#define RV3032_ENABLE_INTERRUPTS           1 // Alarm, countdown timer, periodic update and interrupt flags
+#endif
+#ifndef RV3032_ENABLE_EVI
+#define RV3032_ENABLE_EVI                  1 // EVI configuration, capture and event draining
+#endif
+#ifndef RV3032_ENABLE_ENERGY
+#define RV3032_ENABLE_ENERGY               1 // Bus transaction accounting for RV3032EnergyMeter
+#endif
+#ifndef RV3032_ENABLE_TRACE
+#define RV3032_ENABLE_TRACE                1 // Bus transaction recording for RV3032TraceRecorder
+#endif
+
+#define SUNDAY 0x01
+#define MONDAY 0x02
+#define TUESDAY 0x04
+#define WEDNESDAY 0x08
+#define THURSDAY 0x10
+#define FRIDAY 0x20
+#define SATURDAY 0x40
+
+//Enable Bits for Alarm Registers
+#define ALARM_ENABLE						7
+
+//Interrupt enable bits, the same positions on both chips
+#define UPDATE_INTERRUPT        5
+#define TIMER_INTERRUPT         4
+#define ALARM_INTERRUPT         3
+#define EVI_INTERRUPT           2
+
+//Flag Register Bits, the same positions on both chips
+#define FLAG_UPDATE             5
+#define FLAG_TIMER              4
+#define FLAG_ALARM              3
+#define FLAG_EVI                2
+
+//Possible Settings
+#define TWELVE_HOUR_MODE					         true
+#define TWENTYFOUR_HOUR_MODE				       false
+#define COUNTDOWN_TIMER_FREQUENCY_4096_HZ	 0b00
+#define COUNTDOWN_TIMER_FREQUENCY_64_HZ		 0b01
+#define COUNTDOWN_TIMER_FREQUENCY_1_HZ		 0b10
+#define COUNTDOWN_TIMER_FREQUENCY_1/60_HZ	 0b11
+
+#define COUNTDOWN_TIMER_ON				       	 true
+#define COUNTDOWN_TIMER_OFF					       false
+#define TIME_UPDATE_1_SECOND				       false
+#define TIME_UPDATE_1_MINUTE				       true
+
+#define ENABLE_EVI_CALIBRATION				     true
+#define DISABLE_EVI_CALIBRATION				     false
+#define EVI_DEBOUNCE_NONE					         0b00 // 0ms, default
+#define EVI_DEBOUNCE_256HZ					       0b01 // 256Hz ~= 3.9ms
+#define EVI_DEBOUNCE_64HZ					         0b10 // 64Hz ~= 15.6ms
+#define EVI_DEBOUNCE_8HZ					         0b11 // 8Hz ~= 125ms
+#define RISING_EDGE							           true
+#define FALLING_EDGE						           false
+#define EVI_CAPTURE_ENABLE			        	 true
+#define EVI_CAPTURE_DISABLE					       false
+
+#define ENABLE								             true
+#define DISABLE								             false
+
+#define TIME_ARRAY_LENGTH                  8 // Total number of writable values in device
+#define RV3032_TIME_MANUAL                 0xFFFF // setTimeMaxAge(): getters only return what updateTime() read
+
+enum time_order {
+	TIME_HUNDREDTHS,	// 0
+	TIME_SECONDS,		// 1
+	TIME_MINUTES,		// 2
+	TIME_HOURS,			// 3
+	TIME_WEEKDAY,		// 4
+	TIME_DATE,			// 5
+	TIME_MONTH,			// 6
+	TIME_YEAR,			// 7
+};
+
+/*********************************
+A chip traits struct provides, as static const members:
+ADDRESS                    7-bit I2C address
+TIME_REG                   Hundredths register, seconds to year follow in time_order
+WEEKDAY_ONE_HOT            true if the weekday register is one bit per day, false for a 0-6 value
+ALARM_REG                  Minutes alarm, hours and date alarms follow
+WEEKDAY_ALARM              true if the date alarm register doubles as a weekday alarm
+ALARM_SELECT_REG/_BIT      Where the date/weekday alarm select bit is (WEEKDAY_ALARM only)
+TIMER_REG                  Countdown timer low byte, high nibble follows
+TIMER_CONTROL_REG          Register holding the timer enable, timer frequency and update select bits
+TIMER_ENABLE_BIT, TIMER_FREQUENCY_BIT, UPDATE_SELECT_BIT
+INTERRUPT_REG              Interrupt enables (UIE, TIE, AIE, EIE at the bits above)
+HOLD_BIT                   Bit of INTERRUPT_REG that stops the prescaler while set
+FLAG_REG                   Interrupt flags (UF, TF, AF, EVF at the bits above)
+EVI_CONTROL_REG            EVI edge, filter and sync settings
+EVI_EDGE_BIT, EVI_FILTER_BIT, EVI_SYNC_BIT
+CAPTURE_REG                EVI capture, starting with hundredths
+CAPTURE_FIELDS             Number of capture registers, in time_order without the weekday
+OFFSET_REG                 6 bit two's complement frequency offset
+OFFSET_STEP_TENTH_PPB      Offset step in 0.1 ppb (2384 is 0.2384 ppm)
+CLKOUT_REG/_BIT            CLKOUT frequency select, two bits
+*********************************/
+template <class Chip>
+class RVClockCore
+{
+public:
+
+	bool begin(TwoWire &wirePort = Wire);
+
+	void set12Hour();
+	void set24Hour();
+	bool is12Hour(); //Returns true if 12hour bit is set
+	bool isPM(); //Returns true if is12Hour and PM bit is set
+
+#if RV3032_ENABLE_FORMATTING
+	char* stringDateUSA(); //Return date in mm-dd-yyyy
+	char* stringDate(); //Return date in dd-mm-yyyy
+	char* stringTime(); //Return time hh:mm:ss with AM/PM if in 12 hour mode
+	char* stringTimestamp(); //Return timestamp in hh:mm:ss:hh, fields the chip doesn't capture come from the last updateTime()
+	char* stringTime8601(); //Return time in ISO 8601 format yyyy-mm-ddThh:mm:ss
+#endif
+
+	bool setTime(uint8_t sec, uint8_t min, uint8_t hour, uint8_t weekday, uint8_t date, uint8_t month, uint16_t year);
+	bool setTime(uint8_t * time, uint8_t len);
+	bool setHundredthsToZero();
+	bool setSeconds(uint8_t value);
+	bool setMinutes(uint8_t value);
+	bool setHours(uint8_t value);
+	bool setDate(uint8_t value);
+	bool setWeekday(uint8_t value);
+	bool setMonth(uint8_t value);
+	bool setYear(uint16_t value);
+#if RV3032_ENABLE_EPOCH
+	bool setEpoch(uint32_t value);
+#endif
+
+	bool updateTime(); //Update the local array with the RTC registers
+
+	//Refresh policy. With a max age the getters call updateTime() themselves when the local copy is older
+	//than that or a time update interrupt came in, otherwise they return what the last updateTime() read.
+	//Each getter checks on its own: wrap getters that belong together in holdTime() or an RV3032TimeHold
+	void setTimeMaxAge(uint16_t maxAgeMs); //0 reads on every getter outside a hold, RV3032_TIME_MANUAL (default) never
+	uint16_t getTimeMaxAge();
+	void notifyTimeUpdate(); //Call from the periodic time update (UF) interrupt, the next getter reads the new time. No I2C
+	uint32_t getTimeAge(); //Milliseconds since the last successful updateTime()
+	void holdTime(); //Refreshes if due, then every getter uses that copy until releaseTime(). Holds nest
+	void releaseTime();
+
+	uint8_t getHundredths();
+	uint8_t getSeconds();
+	uint8_t getMinutes();
+	uint8_t getHours();
+	uint8_t getDate();
+	uint8_t getWeekday();
+	uint8_t getMonth();
+	uint16_t getYear();
+#if RV3032_ENABLE_EPOCH
+	uint32_t getEpoch(); //UTC, independent of the libc time zone
+	uint32_t getLocalEpoch(RV3032TimeZone &zone); //getEpoch() converted to local time
+#endif
+	uint64_t getTimestamp(); //Hundredths of a second since 2000-01-01, fits in 40 bits
+	uint8_t getPackedTimestamp(uint8_t * dest); //Writes getTimestamp() as RV3032_PACKED_LENGTH bytes, returns the length
+
+	bool setToCompilerTime(); //Uses the hours, mins, etc from compile time to set RTC
+
+#if RV3032_ENABLE_EEPROM
+	bool setCalibrationOffsetSteps(int8_t steps); //-32 to 31 steps of 0.2384 ppm
+	int8_t getCalibrationOffsetSteps();
+#if RV3032_ENABLE_FLOAT
+	bool setCalibrationOffset(float ppm);
+	float getCalibrationOffset();
+#endif
+
+	bool setClockOutTimerFrequency(uint8_t clockOutTimerFrequency);
+	uint8_t getClockOutTimerFrequency();
+#endif
+
+#if RV3032_ENABLE_EVI
+	uint8_t getHundredthsCapture();
+	uint8_t getSecondsCapture();
+
+	bool setEVICalibration(bool eviCalibration);
+	bool setEVIDebounceTime(uint8_t debounceTime);
+	bool setEVIEdgeDetection(bool edge);
+
+	bool getEVICalibration();
+	uint8_t getEVIDebounceTime();
+	bool getEVIEdgeDetection();
+#endif
+
+#if RV3032_ENABLE_INTERRUPTS
+	bool setCountdownTimerEnable(bool timerState); //Starts and stops our countdown timer
+	bool setCountdownTimerClockTicks(uint16_t clockTicks);
+	bool setCountdownTimerFrequency(uint8_t countdownTimerFrequency);
+
+	bool getCountdownTimerEnable();
+	uint16_t getCountdownTimerClockTicks();
+	uint8_t getCountdownTimerFrequency();
+
+	bool setPeriodicTimeUpdateFrequency(bool timeUpdateFrequency);
+	bool getPeriodicTimeUpdateFrequency();
+
+	void setItemsToMatchForAlarm(bool minuteAlarm, bool hourAlarm, bool dateAlarm); //0 to 7, alarm goes off with match of second, minute, hour, etc
+	bool setAlarmMinutes(uint8_t minute);
+	bool setAlarmHours(uint8_t hour);
+	bool setAlarmDate(uint8_t date);
+#if RV3032_ENABLE_EPOCH
+	bool setAlarmLocal(uint8_t hour, uint8_t minute, RV3032TimeZone &zone); //Next local hh:mm, programmed in UTC. Call updateTime() first
+#endif
+
+	uint8_t getAlarmMinutes();
+	uint8_t getAlarmHours();
+	uint8_t getAlarmDate();
+
+	bool enableHardwareInterrupt(uint8_t source); //Enables a given interrupt within Interrupt Enable register
+	bool disableHardwareInterrupt(uint8_t source); //Disables a given interrupt within Interrupt Enable register
+	bool disableAllInterrupts();
+
+	bool getInterruptFlag(uint8_t flagToGet);
+	bool clearInterruptFlag(uint8_t flagToClear);
+	bool clearAllInterruptFlags();
+#endif
+
+	//Values in RTC are stored in Binary Coded Decimal. These functions convert to/from Decimal
+	uint8_t BCDtoDEC(uint8_t val) { return ( ( val / 0x10) * 10 ) + ( val % 0x10 ); }
+	uint8_t DECtoBCD(uint8_t val) { return ( ( val / 10 ) * 0x10 ) + ( val % 10 ); }
+
+	bool readBit(uint8_t regAddr, uint8_t bitAddr);
+	uint8_t readTwoBits(uint8_t regAddr, uint8_t bitAddr);
+	bool writeBit(uint8_t regAddr, uint8_t bitAddr, bool bitToWrite);
+	bool writeBit(uint8_t regAddr, uint8_t bitAddr, uint8_t bitToWrite);
+	uint8_t readRegister(uint8_t addr);
+	bool writeRegister(uint8_t addr, uint8_t val);
+	bool readMultipleRegisters(uint8_t addr, uint8_t * dest, uint8_t len);
+	bool writeMultipleRegisters(uint8_t addr, uint8_t * values, uint8_t len);
+
+	void setEnergyMeter(RV3032EnergyMeter *meter); //Every bus transaction is added to meter, NULL to stop
+	void setTraceRecorder(RV3032TraceRecorder *recorder); //Every bus transaction is logged to recorder, NULL to stop
+
+  protected:
+	uint8_t encodeWeekday(uint8_t weekday); //0=sunday to 6=saturday in the chip's register format
+	void epochToTime(uint32_t value); //Fills _time from a UNIX epoch without touching the RTC
+	void refreshTime(); //updateTime() if the refresh policy says the copy is due
+	bool commitTime(uint8_t * time); //The second half of updateTime(): checks a time read at 59 seconds and makes it the local copy
+	void countTransaction(uint8_t bytes)
+	{
+#if RV3032_ENABLE_ENERGY
+		if (_energyMeter != NULL)
+			_energyMeter->addTransaction(bytes);
+#else
+		(void)bytes;
+#endif
+	}
+	uint32_t traceStart() //micros() only costs anything with a recorder attached
+	{
+#if RV3032_ENABLE_TRACE
+		if (_traceRecorder != NULL)
+			return micros();
+#endif
+		return 0;
+	}
+	void traceTransaction(uint32_t start, bool read, const uint8_t * pointer, const uint8_t * data, uint8_t len, bool ack); //pointer is NULL for reads and the address probe
+
+	uint8_t _time[TIME_ARRAY_LENGTH];
+	uint16_t _timeMaxAge = RV3032_TIME_MANUAL;
+	uint32_t _timeMillis = 0; //millis() at the last successful updateTime()
+	bool _timeRead = false; //_time has come from the RTC at least once
+	volatile bool _timeUpdated = false; //Set by notifyTimeUpdate()
+	uint8_t _timeHolds = 0;
+	bool _isTwelveHour = true;
+	TwoWire *_i2cPort;
+	RV3032EnergyMeter *_energyMeter = NULL; //Kept with the gate off so the layout never changes
+	RV3032TraceRecorder *_traceRecorder = NULL; //Same
+};
+
+//Keeps the time copy of a clock for as long as it is in scope, so the getters in it share one reading
+//  { RV3032TimeHold hold(rtc); minutes = rtc.getHours() * 60 + rtc.getMinutes(); }
+template <class Clock>
+class RVTimeHold
+{
+public:
+
+	RVTimeHold(Clock &rtc) : _rtc(rtc) { _rtc.holdTime(); }
+	~RVTimeHold() { _rtc.releaseTime(); }
+	RVTimeHold(const RVTimeHold &) = delete;
+	RVTimeHold &operator=(const RVTimeHold &) = delete;
+
+  private:
+	Clock &_rtc;
+};
@@ -1,5 +1,5 @@
- /******************************************************************************
-SparkFun_RV3032.h
+/******************************************************************************
+SparkFun_RV3032.cpp
 RV3032 Arduino Library
 
 Originally written for RV-8803-C7 by:
@@ -18,720 +18,515 @@ or concerns with licensing, please contact techsupport@sparkfun.com.
 Distributed as-is; no warranty is given.
 ******************************************************************************/
 
-#include <time.h>
 #include "SparkFun_RV3032.h"
 
 //****************************************************************************//
 //
-//  Settings and configuration
+//  RV-3032 specific functions, the shared ones live in RV_ClockCore.cpp
 //
 //****************************************************************************//
 
-// Parse the __DATE__ predefined macro to generate date defaults:
-// __Date__ Format: MMM DD YYYY (First D may be a space if <10)
-// <MONTH>
-#define BUILD_MONTH_JAN ((__DATE__[0] == 'J') && (__DATE__[1] == 'a')) ? 1 : 0
-#define BUILD_MONTH_FEB (__DATE__[0] == 'F') ? 2 : 0
-#define BUILD_MONTH_MAR ((__DATE__[0] == 'M') && (__DATE__[1] == 'a') && (__DATE__[2] == 'r')) ? 3 : 0
-#define BUILD_MONTH_APR ((__DATE__[0] == 'A') && (__DATE__[1] == 'p')) ? 4 : 0
-#define BUILD_MONTH_MAY ((__DATE__[0] == 'M') && (__DATE__[1] == 'a') && (__DATE__[2] == 'y')) ? 5 : 0
-#define BUILD_MONTH_JUN ((__DATE__[0] == 'J') && (__DATE__[1] == 'u') && (__DATE__[2] == 'n')) ? 6 : 0
-#define BUILD_MONTH_JUL ((__DATE__[0] == 'J') && (__DATE__[1] == 'u') && (__DATE__[2] == 'l')) ? 7 : 0
-#define BUILD_MONTH_AUG ((__DATE__[0] == 'A') && (__DATE__[1] == 'u')) ? 8 : 0
-#define BUILD_MONTH_SEP (__DATE__[0] == 'S') ? 9 : 0
-#define BUILD_MONTH_OCT (__DATE__[0] == 'O') ? 10 : 0
-#define BUILD_MONTH_NOV (__DATE__[0] == 'N') ? 11 : 0
-#define BUILD_MONTH_DEC (__DATE__[0] == 'D') ? 12 : 0
-#define BUILD_MONTH BUILD_MONTH_JAN | BUILD_MONTH_FEB | BUILD_MONTH_MAR | \
-BUILD_MONTH_APR | BUILD_MONTH_MAY | BUILD_MONTH_JUN | \
-BUILD_MONTH_JUL | BUILD_MONTH_AUG | BUILD_MONTH_SEP | \
-BUILD_MONTH_OCT | BUILD_MONTH_NOV | BUILD_MONTH_DEC
-// <DATE>
-#define BUILD_DATE_0 ((__DATE__[4] == ' ') ? 0 : (__DATE__[4] - 0x30))
-#define BUILD_DATE_1 (__DATE__[5] - 0x30)
-#define BUILD_DATE ((BUILD_DATE_0 * 10) + BUILD_DATE_1)
-// <YEAR>
-#define BUILD_YEAR (((__DATE__[7] - 0x30) * 1000) + ((__DATE__[8] - 0x30) * 100) + \
-((__DATE__[9] - 0x30) * 10)  + ((__DATE__[10] - 0x30) * 1))
-
-// Parse the __TIME__ predefined macro to generate time defaults:
-// __TIME__ Format: HH:MM:SS (First number of each is padded by 0 if <10)
-// <HOUR>
-#define BUILD_HOUR_0 ((__TIME__[0] == ' ') ? 0 : (__TIME__[0] - 0x30))
-#define BUILD_HOUR_1 (__TIME__[1] - 0x30)
-#define BUILD_HOUR ((BUILD_HOUR_0 * 10) + BUILD_HOUR_1)
-// <MINUTE>
-#define BUILD_MINUTE_0 ((__TIME__[3] == ' ') ? 0 : (__TIME__[3] - 0x30))
-#define BUILD_MINUTE_1 (__TIME__[4] - 0x30)
-#define BUILD_MINUTE ((BUILD_MINUTE_0 * 10) + BUILD_MINUTE_1)
-// <SECOND>
-#define BUILD_SECOND_0 ((__TIME__[6] == ' ') ? 0 : (__TIME__[6] - 0x30))
-#define BUILD_SECOND_1 (__TIME__[7] - 0x30)
-#define BUILD_SECOND ((BUILD_SECOND_0 * 10) + BUILD_SECOND_1)
-
 RV3032::RV3032( void )
 {
 
 }
 
+//Probes the RTC. It may have been reset since the last begin(), so the TS control copy is dropped
 bool RV3032::begin(TwoWire &wirePort)
 {
-	_i2cPort = &wirePort;
-	
-	_i2cPort->beginTransmission(RV3032_ADDR);
-	
-	if (_i2cPort->endTransmission() != 0)
-	{
-		return (false); //Error: Sensor did not ack
-	}
-	return(true);
+	_tsControlKnown = false;
+	return RVClockCore<RV3032Traits>::begin(wirePort);
 }
 
-//Configures the microcontroller to convert to 12 hour mode.
-void RV3032::set12Hour()
+//Starts like begin() and, if the RTC lost power (PORF) or its supply dropped too low (VLF), writes image back.
+//The flags are left set so the application can still see that the time needs to be set
+bool RV3032::begin(const RV3032ConfigImage &image, TwoWire &wirePort)
 {
-	_isTwelveHour = TWELVE_HOUR_MODE;
-}
+	if (begin(wirePort) == false)
+		return false;
 
-//Configures the microcontroller to not convert from the default 24 hour mode.
-void RV3032::set24Hour()
-{
-	_isTwelveHour = TWENTYFOUR_HOUR_MODE;
+	uint8_t status = readRegister(RV3032_STATUS);
+	if (status & ((1 << STATUS_PORF) | (1 << STATUS_VLF)))
+	{
+		return restoreConfig(image);
+	}
+	return true;
 }
 
-//Returns true if the microcontroller has been configured for 12 hour mode
-bool RV3032::is12Hour()
+/*********************************
+Applies an RV3032Config. Registers 0x08-0x15 go out in a single burst: the image carries 1s for the
+status and temperature flags, and writing 1 to a flag leaves it untouched. EEPROM mirror bits are only
+written (read-modify-write) if the config sets CLKOUT, and such a config also sets EERD so the daily
+EEPROM refresh doesn't revert them. An invalid config is refused before anything goes on the bus.
+*********************************/
+bool RV3032::begin(const RV3032Config &config, TwoWire &wirePort)
 {
-	return _isTwelveHour;
-}
+	if (config.isValid() == false)
+		return false;
+	if (begin(wirePort) == false)
+		return false;
 
-//Returns true if the microcontroller is in 12 hour mode and the RTC has an hours value greater than or equal to 12 (Noon).
-bool RV3032::isPM()
-{
-	if (is12Hour())
+	uint8_t image[CONFIG_CONTROL_LENGTH];
+	for (uint8_t i = 0; i < CONFIG_CONTROL_LENGTH; i++)
 	{
-		return BCDtoDEC(_time[TIME_HOURS]) >= 12;
+		image[i] = config.getRegister(i);
 	}
-	else
+	bool returnValue = writeMultipleRegisters(RV3032_MINUTES_ALARM, image, CONFIG_CONTROL_LENGTH);
+
+	if (config.getRegister(CONFIG_SLOT_PMU_MASK) != 0)
 	{
-		return false;
+		uint8_t value = readRegister(RV3032_EEPROM_PMU) & ~config.getRegister(CONFIG_SLOT_PMU_MASK);
+		returnValue &= writeRegister(RV3032_EEPROM_PMU, value | config.getRegister(CONFIG_SLOT_PMU));
 	}
-}
-
-//Returns the date in MM/DD/YYYY format.
-char* RV3032::stringDateUSA()
-{
-	static char date[11]; //Max of mm/dd/yyyy with \0 terminator
-	sprintf(date, "%02d/%02d/20%02d", BCDtoDEC(_time[TIME_MONTH]), BCDtoDEC(_time[TIME_DATE]), BCDtoDEC(_time[TIME_YEAR]));
-	return(date);
-}
-
-//Returns the date in the DD/MM/YYYY format.
-char*  RV3032::stringDate()
-{
-	static char date[11]; //Max of dd/mm/yyyy with \0 terminator
-	sprintf(date, "%02d/%02d/20%02d", BCDtoDEC(_time[TIME_DATE]), BCDtoDEC(_time[TIME_MONTH]), BCDtoDEC(_time[TIME_YEAR]));
-	return(date);
-}
-
-//Returns the time in hh:mm:ss (Adds AM/PM if in 12 hour mode).
-char* RV3032::stringTime()
-{
-	static char time[11]; //Max of hh:mm:ssXM with \0 terminator
-
-	if(is12Hour() == true)
+	if (config.getRegister(CONFIG_SLOT_CLKOUT2_MASK) != 0)
 	{
-		char half = 'A';
-		uint8_t twelveHourCorrection = 0;
-		if(isPM())
-		{
-			half = 'P';
-			if (BCDtoDEC(_time[TIME_HOURS]) > 12)
-			{
-				twelveHourCorrection = 12;
-			}
-		}
-		sprintf(time, "%02d:%02d:%02d%cM", BCDtoDEC(_time[TIME_HOURS]) - twelveHourCorrection, BCDtoDEC(_time[TIME_MINUTES]), BCDtoDEC(_time[TIME_SECONDS]), half);
+		uint8_t value = readRegister(RV3032_EEPROM_CLKOUT_2) & ~config.getRegister(CONFIG_SLOT_CLKOUT2_MASK);
+		returnValue &= writeRegister(RV3032_EEPROM_CLKOUT_2, value | config.getRegister(CONFIG_SLOT_CLKOUT2));
 	}
-	else
-	sprintf(time, "%02d:%02d:%02d", BCDtoDEC(_time[TIME_HOURS]), BCDtoDEC(_time[TIME_MINUTES]), BCDtoDEC(_time[TIME_SECONDS]));
-	
-	return(time);
+
+	_isTwelveHour = config.getTwelveHour();
+	return returnValue;
 }
 
-//Returns the most recent timestamp captured on the EVI pin (if the EVI pin has been configured to capture events)
-//RV-3032-C7 also captures day, month, and year when EVI pin is triggered. Modify string to include RV3032_DAY_CAPTURE, RV3032_MONTH_CAPTURE, and RV3032_YEAR_CAPTURE if desired
-char* RV3032::stringTimestamp()
+static uint8_t configCRC(const RV3032ConfigImage &image)
 {
-	static char time[14]; //Max of hh:mm:ss:HHXM with \0 terminator
-
-	if(is12Hour() == true)
+	uint8_t crc = 0xFF;
+	for (uint8_t i = 0; i < CONFIG_CONTROL_LENGTH + CONFIG_EEPROM_LENGTH; i++)
 	{
-		char half = 'A';
-		uint8_t twelveHourCorrection = 0;
-		if(isPM())
+		crc ^= (i < CONFIG_CONTROL_LENGTH) ? image.control[i] : image.eeprom[i - CONFIG_CONTROL_LENGTH];
+		for (uint8_t bit = 0; bit < 8; bit++)
 		{
-			half = 'P';
-			if (BCDtoDEC(_time[TIME_HOURS]) > 12)
-			{
-				twelveHourCorrection = 12;
-			}
+			crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
 		}
-		sprintf(time, "%02d:%02d:%02d:%02d%cM", BCDtoDEC(readRegister(RV3032_HOURS_CAPTURE)) - twelveHourCorrection, BCDtoDEC(readRegister(RV3032_MINUTES_CAPTURE)),  BCDtoDEC(readRegister(RV3032_SECONDS_CAPTURE)), BCDtoDEC(readRegister(RV3032_HUNDREDTHS_CAPTURE)), half);
 	}
-	else
-	sprintf(time, "%02d:%02d:%02d:%02d", BCDtoDEC(readRegister(RV3032_HOURS_CAPTURE)), BCDtoDEC(readRegister(RV3032_MINUTES_CAPTURE)), BCDtoDEC(readRegister(RV3032_SECONDS_CAPTURE)), BCDtoDEC(readRegister(RV3032_HUNDREDTHS_CAPTURE)));
-	
-	return(time);
+	return crc;
 }
 
-//Returns timestamp in ISO 8601 format (yyyy-mm-ddThh:mm:ss).
-char* RV3032::stringTime8601()
+//Reads the alarm, timer, interrupt, EVI and CLKOUT configuration in two bursts
+bool RV3032::saveConfig(RV3032ConfigImage &image)
 {
-	static char timeStamp[21]; //Max of yyyy-mm-ddThh:mm:ss with \0 terminator
-
-	sprintf(timeStamp, "20%02d-%02d-%02dT%02d:%02d:%02d", BCDtoDEC(_time[TIME_YEAR]), BCDtoDEC(_time[TIME_MONTH]), BCDtoDEC(_time[TIME_DATE]), BCDtoDEC(_time[TIME_HOURS]), BCDtoDEC(_time[TIME_MINUTES]), BCDtoDEC(_time[TIME_SECONDS]));
-	
-	return(timeStamp);
-}
-
-//Returns time in UNIX Epoch time format
-uint32_t RV3032::getEpoch()
-{
-	struct tm tm;
-
-	tm.tm_isdst = -1;
-	tm.tm_yday = 0;
-	tm.tm_wday = 0;
-	tm.tm_year = BCDtoDEC(_time[TIME_YEAR]) + 100;
-	tm.tm_mon = BCDtoDEC(_time[TIME_MONTH]) - 1;
-	tm.tm_mday = BCDtoDEC(_time[TIME_DATE]);
-	tm.tm_hour = BCDtoDEC(_time[TIME_HOURS]);
-	tm.tm_min = BCDtoDEC(_time[TIME_MINUTES]);
-	tm.tm_sec = BCDtoDEC(_time[TIME_SECONDS]);
-
-  return mktime(&tm);
+	if (readMultipleRegisters(RV3032_MINUTES_ALARM, image.control, CONFIG_CONTROL_LENGTH) == false)
+		return false;
+	if (readMultipleRegisters(RV3032_EEPROM_PMU, image.eeprom, CONFIG_EEPROM_LENGTH) == false)
+		return false;
+	image.crc = configCRC(image);
+	return true;
 }
 
-//Sets time using UNIX Epoch time
-bool RV3032::setEpoch(uint32_t value)
+/*********************************
+Writes a saved configuration back in three bursts: alarms and timer (0x08-0x0C), controls (0x10-0x15)
+and the EEPROM mirror (0xC0-0xC3). Status and temperature are volatile or read only and skipped.
+The self clearing reset bits of TS Control and STOP are never written back.
+*********************************/
+bool RV3032::restoreConfig(const RV3032ConfigImage &image)
 {
-	if (value < 946684800) {
-		value = 946684800; // 2000-01-01 00:00:00
-	}
+	if (configCRC(image) != image.crc)
+		return false;
 
-	struct tm tm;
-	time_t t = value;
-	struct tm* tmp = gmtime(&t);
+	uint8_t controls[RV3032_EVI_CONTROL - RV3032_CONTROL1 + 1];
+	memcpy(controls, image.control + (RV3032_CONTROL1 - RV3032_MINUTES_ALARM), sizeof(controls));
+	controls[RV3032_CONTROL2 - RV3032_CONTROL1] &= ~(1 << CONTROL2_STOP);
+	controls[RV3032_TS_CONTROL - RV3032_CONTROL1] &= ~TS_CONTROL_RESETS;
+	_tsControlKnown = false;
 
-	_time[TIME_SECONDS] = DECtoBCD(tmp->tm_sec);
-	_time[TIME_MINUTES] = DECtoBCD(tmp->tm_min);
-	_time[TIME_HOURS] = DECtoBCD(tmp->tm_hour);
-	_time[TIME_DATE] = DECtoBCD(tmp->tm_mday);
-	_time[TIME_WEEKDAY] = 1 << tmp->tm_wday;
-	_time[TIME_MONTH] = DECtoBCD(tmp->tm_mon + 1);
-	_time[TIME_YEAR] = DECtoBCD(tmp->tm_year - 100);
-		
-	return setTime(_time, TIME_ARRAY_LENGTH); //Subtract one as we don't write to the hundredths register
+	bool returnValue = writeMultipleRegisters(RV3032_MINUTES_ALARM, (uint8_t *)image.control, RV3032_TIMER_1 - RV3032_MINUTES_ALARM + 1);
+	returnValue &= writeMultipleRegisters(RV3032_CONTROL1, controls, sizeof(controls));
+	returnValue &= writeMultipleRegisters(RV3032_EEPROM_PMU, (uint8_t *)image.eeprom, CONFIG_EEPROM_LENGTH);
+	return returnValue;
 }
 
-//Set time and date/day registers of RV3032
-bool RV3032::setTime(uint8_t sec, uint8_t min, uint8_t hour, uint8_t weekday, uint8_t date, uint8_t month, uint16_t year)
+#if RV3032_ENABLE_EPOCH
+/*********************************
+Set the time so that the RTC second boundary lands on the reference second boundary.
+epochMs is the reference (GPS, NTP...) time when syncTo() is called. The next whole second is preloaded,
+the clock is held with STOP while the time is written, and STOP is released one measured bus transaction
+before the boundary so the release lands on it. Nothing but the release write happens in the timed section.
+offsetUs reports how late the clock was released (positive means the RTC runs behind the reference).
+*********************************/
+bool RV3032::syncTo(uint64_t epochMs, int32_t *offsetUs)
 {
-	_time[TIME_SECONDS] = DECtoBCD(sec);
-	_time[TIME_MINUTES] = DECtoBCD(min);
-	_time[TIME_HOURS] = DECtoBCD(hour);
-	_time[TIME_DATE] = DECtoBCD(date);
-	_time[TIME_WEEKDAY] = 1 << weekday;
-	_time[TIME_MONTH] = DECtoBCD(month);
-	_time[TIME_YEAR] = DECtoBCD(year - 2000);
-		
-	return setTime(_time, TIME_ARRAY_LENGTH); //Subtract one as we don't write to the hundredths register
-}
+	uint32_t startUs = micros();
+	uint8_t control2 = readRegister(RV3032_CONTROL2);
+	uint8_t stopped = control2 | (1 << CONTROL2_STOP);
+	uint8_t running = control2 & ~(1 << CONTROL2_STOP);
 
-//Set time and date/day registers of RV3032 (using data array)
-bool RV3032::setTime(uint8_t * time, uint8_t len = 8)
-{
-	if (len != TIME_ARRAY_LENGTH)
+	uint32_t latencyUs = micros();
+	if (writeRegister(RV3032_CONTROL2, stopped) == false)
 		return false;
-	
-	return writeMultipleRegisters(RV3032_SECONDS, time + 1, len - 1); //We use length - 1 as that is the length without the read-only hundredths register. We also point to the second element in the time array as hundredths is read only
-}
-
-bool RV3032::setHundredthsToZero()
-{
-	bool temp = writeBit(RV3032_CONTROL2, CONTROL2_STOP, ENABLE);
-	temp &= writeBit(RV3032_CONTROL2, CONTROL2_STOP, DISABLE);
-	return temp;
-}
+	latencyUs = micros() - latencyUs;
 
-bool RV3032::setSeconds(uint8_t value)
-{
-	_time[TIME_SECONDS] = DECtoBCD(value);
-	return setTime(_time, TIME_ARRAY_LENGTH);
-}
+	uint32_t targetSecond = epochMs / 1000 + 1;
+	uint32_t boundaryUs = (1000 - (uint32_t)(epochMs % 1000)) * 1000UL;
+	//The time write costs about three single writes, plus the release and some margin. Aim for the following second if that doesn't fit
+	if (boundaryUs < (micros() - startUs) + 5 * latencyUs)
+	{
+		targetSecond++;
+		boundaryUs += 1000000UL;
+	}
 
-bool RV3032::setMinutes(uint8_t value)
-{
-	_time[TIME_MINUTES] = DECtoBCD(value);
-	return setTime(_time, TIME_ARRAY_LENGTH);
-}
+	epochToTime(targetSecond);
+	if (setTime(_time, TIME_ARRAY_LENGTH) == false)
+	{
+		writeRegister(RV3032_CONTROL2, running);
+		return false;
+	}
 
-bool RV3032::setHours(uint8_t value)
-{
-	_time[TIME_HOURS] = DECtoBCD(value);
-	return setTime(_time, TIME_ARRAY_LENGTH);
-}
+	while ((micros() - startUs) < boundaryUs - latencyUs)
+		;
+	bool returnValue = writeRegister(RV3032_CONTROL2, running);
+	int32_t offset = (int32_t)((micros() - startUs) - boundaryUs);
 
-bool RV3032::setDate(uint8_t value)
-{
-	_time[TIME_DATE] = DECtoBCD(value);
-	return setTime(_time, TIME_ARRAY_LENGTH);
-}
-
-bool RV3032::setMonth(uint8_t value)
-{
-	_time[TIME_MONTH] = DECtoBCD(value);
-	return setTime(_time, TIME_ARRAY_LENGTH);
+	if (offsetUs != NULL)
+		*offsetUs = offset;
+	return returnValue;
 }
 
-bool RV3032::setYear(uint16_t value)
+/*********************************
+Set the time to epochAtEdge and start the clock on the next edge of a PPS signal read on ppsPin.
+The time is preloaded with the clock stopped, so only the release write follows the edge.
+offsetUs reports the delay between seeing the edge and the release completing.
+*********************************/
+bool RV3032::syncToEdge(uint32_t epochAtEdge, uint8_t ppsPin, bool edge, int32_t *offsetUs)
 {
-	_time[TIME_YEAR] = DECtoBCD(value - 2000);
-	return setTime(_time, TIME_ARRAY_LENGTH);
-}
-
+	uint8_t control2 = readRegister(RV3032_CONTROL2);
+	uint8_t running = control2 & ~(1 << CONTROL2_STOP);
 
-bool RV3032::setWeekday(uint8_t value) //value is anywhere between 0=sunday and 6=saturday
-{
-	if (value > 6)
+	if (writeRegister(RV3032_CONTROL2, control2 | (1 << CONTROL2_STOP)) == false)
+		return false;
+	epochToTime(epochAtEdge);
+	if (setTime(_time, TIME_ARRAY_LENGTH) == false)
 	{
-		value = 6;
+		writeRegister(RV3032_CONTROL2, running);
+		return false;
 	}
-	_time[TIME_WEEKDAY] = 1 << value;
-	return setTime(_time, TIME_ARRAY_LENGTH);
-}
-
-//Move the hours, mins, sec, etc registers from RV-3032 into the _time array
-//Needs to be called before printing time or date
-//We do not protect the GPx registers. They will be overwritten. The user has plenty of RAM if they need it.
-bool RV3032::updateTime()
-{
-	if (readMultipleRegisters(RV3032_HUNDREDTHS, _time, TIME_ARRAY_LENGTH) == false)
-		return(false); //Something went wrong
-	
-	if (BCDtoDEC(_time[TIME_SECONDS]) == 59) //If seconds are at 59, read again to make sure we didn't accidentally skip a minute
-	{	
-		uint8_t tempTime[TIME_ARRAY_LENGTH];
-		if (readMultipleRegisters(RV3032_HUNDREDTHS, tempTime, TIME_ARRAY_LENGTH) == false)
-		{
-			return(false); //Something went wrong
-		}
-		if (BCDtoDEC(tempTime[TIME_SECONDS]) == 0) //If the reading for seconds changed, then our new data is correct, otherwise, we can leave the old data.
+
+	uint32_t startMs = millis();
+	bool previous = digitalRead(ppsPin);
+	while (true)
+	{
+		bool level = digitalRead(ppsPin);
+		if (level != previous && level == edge)
+			break;
+		previous = level;
+		if (millis() - startMs > SYNC_EDGE_TIMEOUT_MS)
 		{
-			memcpy(_time, tempTime, TIME_ARRAY_LENGTH);
+			writeRegister(RV3032_CONTROL2, running); //No edge, leave the clock running rather than stopped
+			return false;
 		}
 	}
-	return true;
-}
 
-uint8_t RV3032::getHundredths()
-{
-	return BCDtoDEC(_time[TIME_HUNDREDTHS]);
+	uint32_t edgeUs = micros();
+	bool returnValue = writeRegister(RV3032_CONTROL2, running);
+	if (offsetUs != NULL)
+		*offsetUs = (int32_t)(micros() - edgeUs);
+	return returnValue;
 }
+#endif
 
-uint8_t RV3032::getSeconds()
+#if RV3032_ENABLE_EEPROM
+//setClockOutTimerFrequency() only picks the frequency, the output itself stays off while NCLKE is set
+bool RV3032::enableClockOut(uint8_t frequency)
 {
-	return BCDtoDEC(_time[TIME_SECONDS]);
+	bool returnValue = setClockOutTimerFrequency(frequency);
+	returnValue &= writeBit(RV3032_EEPROM_PMU, EEPROM_PMU_NCLKE, DISABLE);
+	return returnValue;
 }
 
-uint8_t RV3032::getMinutes()
+bool RV3032::disableClockOut()
 {
-	return BCDtoDEC(_time[TIME_MINUTES]);
+	return writeBit(RV3032_EEPROM_PMU, EEPROM_PMU_NCLKE, ENABLE);
 }
 
-uint8_t RV3032::getHours()
+/*********************************
+Gate CLKOUT with interrupts instead of running it continuously. interruptMask is written to the clock
+interrupt mask register. CLKIE only starts the output on an interrupt if NCLKE keeps it off otherwise,
+so enabling sets NCLKE, like clockOutOnInterrupt() in a power profile. Disabling clears CLKIE and NCLKE:
+CLKOUT runs continuously again, call disableClockOut() afterwards to stop it.
+*********************************/
+bool RV3032::setClockOutInterruptControlled(bool enable, uint8_t interruptMask)
 {
-	uint8_t tempHours = BCDtoDEC(_time[TIME_HOURS]);
-	if (is12Hour())
+	bool returnValue = true;
+	if (enable == true)
 	{
-		if (tempHours > 12)
-		{
-			tempHours -= 12;
-		}
+		returnValue &= writeRegister(RV3032_CLOCK_INT_MASK, interruptMask);
 	}
-	return tempHours;
+	returnValue &= writeBit(RV3032_CONTROL2, CONTROL2_CLKIE, enable);
+	returnValue &= writeBit(RV3032_EEPROM_PMU, EEPROM_PMU_NCLKE, enable);
+	return returnValue;
 }
 
-uint8_t RV3032::getDate()
+/*********************************
+Applies the bits a power profile names and leaves every other bit as it was. Control 1 to the clock
+interrupt mask (0x10-0x14) and the PMU are read first, nothing is written unless both reads worked,
+then the controls go out in one burst followed by the PMU. The controls go first so EERD is already
+set when the PMU changes. Settings in the PMU only live in RAM: with the EEPROM refresh left on they
+revert to the EEPROM values at the next daily refresh.
+*********************************/
+bool RV3032::setPowerProfile(const RV3032PowerProfile &profile)
 {
-	return BCDtoDEC(_time[TIME_DATE]);
-}
+	if (profile.isValid() == false)
+		return false;
 
-uint8_t RV3032::getWeekday()
-{
-	uint8_t tempWeekday = _time[TIME_WEEKDAY];
-	tempWeekday = log(tempWeekday) / log(2);
-	return tempWeekday;
-}
+	uint8_t control[POWER_CONTROL_LENGTH];
+	uint8_t pmu;
+	if (readMultipleRegisters(RV3032_CONTROL1, control, POWER_CONTROL_LENGTH) == false)
+		return false;
+	if (readMultipleRegisters(RV3032_EEPROM_PMU, &pmu, 1) == false)
+		return false;
 
-uint8_t RV3032::getMonth()
-{
-	return BCDtoDEC(_time[TIME_MONTH]);
+	bool returnValue = true;
+	bool controlChanged = false;
+	for (uint8_t i = 0; i < POWER_CONTROL_LENGTH; i++)
+	{
+		uint8_t value = profile.apply(i, control[i]);
+		controlChanged |= (value != control[i]);
+		control[i] = value;
+	}
+	control[POWER_SLOT_TS_CONTROL] &= ~TS_CONTROL_RESETS; //Never trigger a capture reset
+	_tsControlKnown = false;
+	if (controlChanged == true)
+		returnValue &= writeMultipleRegisters(RV3032_CONTROL1, control, POWER_CONTROL_LENGTH);
+
+	uint8_t value = profile.apply(POWER_SLOT_PMU, pmu);
+	if (value != pmu)
+		returnValue &= writeRegister(RV3032_EEPROM_PMU, value);
+	return returnValue;
 }
 
-uint16_t RV3032::getYear()
+uint8_t RV3032::getBackupSwitchoverMode()
 {
-	return BCDtoDEC(_time[TIME_YEAR]) + 2000;
+	return readTwoBits(RV3032_EEPROM_PMU, EEPROM_PMU_BSM);
 }
 
-uint8_t RV3032::getHundredthsCapture()
+bool RV3032::getBackupSwitchoverFlag()
 {
-	return BCDtoDEC(readRegister(RV3032_HUNDREDTHS_CAPTURE));
+	return readBit(RV3032_TEMP_LSB, TEMP_LSB_BSF);
 }
 
-uint8_t RV3032::getSecondsCapture()
+bool RV3032::clearBackupSwitchoverFlag()
 {
-	return BCDtoDEC(readRegister(RV3032_SECONDS_CAPTURE));
+	return writeBit(RV3032_TEMP_LSB, TEMP_LSB_BSF, DISABLE);
 }
+#endif
 
+#if RV3032_ENABLE_EVI
 uint8_t RV3032::getMinutesCapture()
 {
-  return BCDtoDEC(readRegister(RV3032_MINUTES_CAPTURE));
-}
-
-//Takes the time from the last build and uses it as the current time
-//Works very well as an arduino sketch
-bool RV3032::setToCompilerTime()
-{
-	_time[TIME_SECONDS] = DECtoBCD(BUILD_SECOND);
-	_time[TIME_MINUTES] = DECtoBCD(BUILD_MINUTE);
-	_time[TIME_HOURS] = DECtoBCD(BUILD_HOUR);
-	
-	_time[TIME_MONTH] = DECtoBCD(BUILD_MONTH);
-	_time[TIME_DATE] = DECtoBCD(BUILD_DATE);
-	_time[TIME_YEAR] = DECtoBCD(BUILD_YEAR - 2000); //! Not Y2K (or Y2.1K)-proof :(
-	
-	// Calculate weekday (from here: http://stackoverflow.com/a/21235587)
-	// 0 = Sunday, 6 = Saturday
-	uint16_t d = BUILD_DATE;
-	uint16_t m = BUILD_MONTH;
-	uint16_t y = BUILD_YEAR;
-	uint16_t weekday = (d+=m<3?y--:y-2,23*m/9+d+4+y/4-y/100+y/400)%7 + 1;
-	_time[TIME_WEEKDAY] = 1 << weekday;
-	
-	return setTime(_time, TIME_ARRAY_LENGTH);
-}
-
-bool RV3032::setCalibrationOffset(float ppm)
-{
-  uint8_t integerOffset = readRegister(RV3032_EEPROM_OFFSET);
-	
-	integerOffset = ppm / 0.2384; //.2384 is ppm/LSB
-	if (integerOffset < 0)
-	{
-		integerOffset += 64;
-	}
- 
-	return writeRegister(RV3032_EEPROM_OFFSET, integerOffset);
+	return BCDtoDEC(readRegister(RV3032_MINUTES_CAPTURE) & 0x7F);
 }
 
-float RV3032:: getCalibrationOffset()
+//The RV-3032 always timestamps EVI events, so enabling capture starts from a clean counter and routes events to INT
+bool RV3032::setEVIEventCapture(bool capture)
 {
-	int8_t value = readRegister(RV3032_EEPROM_OFFSET);
-  value &= (0b00111111);
-	if (value > 32)
+	bool returnValue = true;
+	if (capture == EVI_CAPTURE_ENABLE)
 	{
-		value -= 64;
+		returnValue &= resetEVICapture();
+		_eviEventTotal = 0;
 	}
-	return value * .2384;
-}
-
-bool RV3032::setEVICalibration(bool eviCalibration)
-{
-  return writeBit(RV3032_CONTROL2, CONTROL2_STOP, eviCalibration);
-}
-
-bool RV3032::setEVIDebounceTime(uint8_t debounceTime)
-{
-	return writeBit(RV3032_EVI_CONTROL, EVI_CONTROL_ET, debounceTime);
-}
-
-bool RV3032::setEVIEdgeDetection(bool edge)
-{
-	return writeBit(RV3032_EVI_CONTROL, EVI_CONTROL_EHL, edge);
-}
-
-bool RV3032::setTSOverwrite(bool overwrite)
-{
-  return writeBit(RV3032_TS_CONTROL, TS_CONTROL_EVOW, overwrite);
-}
-
-uint8_t RV3032::getEVIDebounceTime()
-{
-	return readTwoBits(RV3032_EVI_CONTROL, EVI_CONTROL_ET);
-}
-
-bool RV3032::getEVICalibration()
-{
-	return readBit(RV3032_EVI_CONTROL, EVI_CONTROL_ESYN);
-}
-
-bool RV3032::getEVIEdgeDetection()
-{
-	return readBit(RV3032_EVI_CONTROL, EVI_CONTROL_EHL);
-}
-
-bool RV3032::setCountdownTimerEnable(bool timerState)
-{
-	return writeBit(RV3032_CONTROL1, CONTROL1_TE, timerState);
-}
-
-bool RV3032::setCountdownTimerFrequency(uint8_t countdownTimerFrequency)
-{
-	return writeBit(RV3032_CONTROL1, CONTROL1_TD, countdownTimerFrequency);
-}
-
-bool RV3032::setCountdownTimerClockTicks(uint16_t clockTicks)
-{
-	//First handle the upper bit, as we need to preserve the GPX bits
-	uint8_t value = readRegister(RV3032_TIMER_1);
-	value &= (0<<8); //Clear the least significant nibble
-	value |= (clockTicks >> 8);
-	bool returnValue = writeRegister(RV3032_TIMER_1, value);
-	value = clockTicks & 0x00FF;
-	returnValue &= writeRegister(RV3032_TIMER_0, value);
+	returnValue &= writeBit(RV3032_CONTROL2, CONTROL2_EIE, capture);
 	return returnValue;
 }
 
-bool RV3032::setClockOutTimerFrequency(uint8_t clockOutTimerFrequency)
-{
-  writeBit(RV3032_EEPROM_CLKOUT_2, EEPROM_CLKOUT2_FD, DISABLE);
-	return writeBit(RV3032_EEPROM_CLKOUT_2, EEPROM_CLKOUT2_FD, clockOutTimerFrequency);
-}
-
-bool RV3032::getCountdownTimerEnable()
-{
-	return readBit(RV3032_CONTROL1, CONTROL1_TE);
-}
-
-uint8_t RV3032::getCountdownTimerFrequency()
-{
-	return readTwoBits(RV3032_CONTROL1, CONTROL1_TD);
-}
-
-uint16_t RV3032::getCountdownTimerClockTicks()
-{
-	uint16_t value = readRegister(RV3032_TIMER_1) << 8;
-	value |= readRegister(RV3032_TIMER_0);
-	return value;
-}
-
-uint8_t RV3032::getClockOutTimerFrequency()
-{
-	return readTwoBits(RV3032_EEPROM_CLKOUT_2, EEPROM_CLKOUT2_FD);
-}
-
-bool RV3032::setPeriodicTimeUpdateFrequency(bool timeUpdateFrequency)
+//EVI_CAPTURE_FIRST_EVENT keeps the first timestamp after a reset, EVI_CAPTURE_LAST_EVENT keeps the most recent one
+bool RV3032::setTSOverwrite(bool overwrite)
 {
-		return writeBit(RV3032_CONTROL1, CONTROL1_USEL, timeUpdateFrequency);
-}
-
-bool RV3032::getPeriodicTimeUpdateFrequency()
-{	
-	return readBit(RV3032_CONTROL1, CONTROL1_USEL);
+	if (loadTSControl() == false)
+		return false;
+	uint8_t value = (_tsControl & ~(1 << TS_CONTROL_EVOW)) | (overwrite << TS_CONTROL_EVOW);
+	_tsControlKnown = writeRegister(RV3032_TS_CONTROL, value);
+	_tsControl = value;
+	return _tsControlKnown;
 }
 
-/********************************
-Set Alarm Mode controls which parts of the time have to match for the alarm to trigger.
-When the RTC matches a given time, make an interrupt fire.
-Setting a bit to 1 means that the RTC does not check if that value matches to trigger the alarm
-********************************/
-void RV3032::setItemsToMatchForAlarm(bool minuteAlarm, bool hourAlarm, bool dateAlarm)
+bool RV3032::resetEVICapture()
 {
-	writeBit(RV3032_MINUTES_ALARM, ALARM_ENABLE, !minuteAlarm); //For some reason these bits are active low
-	writeBit(RV3032_HOURS_ALARM, ALARM_ENABLE, !hourAlarm);
-	writeBit(RV3032_DATE_ALARM, ALARM_ENABLE, !dateAlarm);
+	if (loadTSControl() == false)
+		return false;
+	return writeRegister(RV3032_TS_CONTROL, _tsControl | (1 << TS_CONTROL_EVR)); //EVR clears itself once the reset is done
 }
 
-bool RV3032::setAlarmMinutes(uint8_t minute)
+bool RV3032::loadTSControl()
 {
-	uint8_t value = readRegister(RV3032_MINUTES_ALARM);
-	value &= (1 << ALARM_ENABLE); //clear everything but enable bit
-	value |= DECtoBCD(minute);
-	return writeRegister(RV3032_MINUTES_ALARM, value);
+	if (_tsControlKnown == true)
+		return true;
+	if (readMultipleRegisters(RV3032_TS_CONTROL, &_tsControl, 1) == false)
+		return false;
+	_tsControl &= ~TS_CONTROL_RESETS;
+	_tsControlKnown = true;
+	return true;
 }
 
-bool RV3032::setAlarmHours(uint8_t hour)
+/*********************************
+Read the event counter and the full capture block in one burst, then clear EVF and reset them.
+Each drain pushes one decoded event carrying the number of events counted since the previous drain.
+Events arriving between the burst read and the EVR reset are not counted, so drain often enough that
+this window (two register writes) is short compared to the event rate. TS control is known from an
+earlier call, or read before the burst, so nothing else lands in the window.
+If either write fails nothing is pushed and the capture is left for the next drain, which can't count
+it twice because the reset didn't happen.
+*********************************/
+uint8_t RV3032::drainEVIEvents(RV3032EventBuffer &buffer)
 {
-	uint8_t value = readRegister(RV3032_HOURS_ALARM);
-	value &= (1 << ALARM_ENABLE); //clear everything but enable bit
-	value |= DECtoBCD(hour);
-	return writeRegister(RV3032_HOURS_ALARM, value);
-}
+	if (loadTSControl() == false)
+		return 0; //Something went wrong
 
-bool RV3032::setAlarmDate(uint8_t date)
-{
-	uint8_t value = readRegister(RV3032_DATE_ALARM);
-	value &= (1 << ALARM_ENABLE); //clear everything but enable bit
-	value |= DECtoBCD(date);
-	return writeRegister(RV3032_DATE_ALARM, value);
-}
+	uint8_t capture[EVI_CAPTURE_LENGTH];
+	if (readMultipleRegisters(RV3032_EVI_COUNT, capture, EVI_CAPTURE_LENGTH) == false)
+		return 0; //Something went wrong
 
+	if (capture[0] == 0)
+		return 0; //Nothing happened since the last drain
 
-uint8_t RV3032::getAlarmMinutes()
-{
-	return BCDtoDEC(readRegister(RV3032_MINUTES_ALARM));
-}
+	if (writeRegister(RV3032_STATUS, (uint8_t)~(1 << STATUS_EVF)) == false) //Writing 1 leaves the other flags untouched
+		return 0;
+	if (writeRegister(RV3032_TS_CONTROL, _tsControl | (1 << TS_CONTROL_EVR)) == false)
+		return 0;
 
+	RV3032Event event;
+	event.count = capture[0];
+	event.hundredths = BCDtoDEC(capture[1]);
+	event.seconds = BCDtoDEC(capture[2] & 0x7F);
+	event.minutes = BCDtoDEC(capture[3] & 0x7F);
+	event.hours = BCDtoDEC(capture[4] & 0x3F);
+	event.date = BCDtoDEC(capture[5] & 0x3F);
+	event.month = BCDtoDEC(capture[6] & 0x1F);
+	event.year = BCDtoDEC(capture[7]);
+	buffer.push(event);
 
-uint8_t RV3032::getAlarmHours()
-{
-	return BCDtoDEC(readRegister(RV3032_HOURS_ALARM));
+	_eviEventTotal += event.count;
+	return event.count;
 }
 
-uint8_t RV3032::getAlarmDate()
+uint32_t RV3032::getEVIEventTotal()
 {
-	return BCDtoDEC(readRegister(RV3032_DATE_ALARM));
+	return _eviEventTotal;
 }
 
 /*********************************
-Given a bit location, enable the interrupt
-INTERRUPT_CLKIE 6
-INTERRUPT_UIE  	5
-INTERRUPT_TIE	  4
-INTERRUPT_AIE  	3
-INTERRUPT_EIE 	2
+The RV-3032 has no switchover timestamp of its own, but EVI keeps working on VBACKUP. With the main
+supply (through a divider if needed) on EVI, a falling edge stamps the moment it drops and BSF says
+the RTC ran from the backup. TS control, the clock interrupt mask and EVI control (0x13-0x15) are read
+and written back in one burst: EVOW keeps the last drop, EVR clears the capture, ESYN stays off so the
+drop can't reset the clock. Backup switchover itself is set in the PMU, see setPowerProfile().
 *********************************/
-bool RV3032::enableHardwareInterrupt(uint8_t source)
+bool RV3032::enableOutageCapture(uint8_t debounceTime)
 {
-	uint8_t value = readRegister(RV3032_CONTROL2);
-	value |= (1<<source); //Set the interrupt enable bit
-	return writeRegister(RV3032_CONTROL2, value);
-}
-
-bool RV3032::disableHardwareInterrupt(uint8_t source)
-{
-	uint8_t value = readRegister(RV3032_CONTROL2);
-	value &= ~(1 << source); //Clear the interrupt enable bit
-	return writeRegister(RV3032_CONTROL2, value);
-}
-
-bool RV3032::disableAllInterrupts()
-{
-	uint8_t value = readRegister(RV3032_CONTROL2);
-	value &= 1; //Clear all bits except for Reset
-	return writeRegister(RV3032_CONTROL2, value);
-}
+	uint8_t control[3];
+	if (readMultipleRegisters(RV3032_TS_CONTROL, control, 3) == false)
+		return false;
 
-bool RV3032::getInterruptFlag(uint8_t flagToGet)
-{
-	uint8_t flag = readRegister(RV3032_STATUS);
-	flag &= (1 << flagToGet);
-	flag = flag >> flagToGet;
-	return flag;
-}
+	control[0] = (control[0] & ~TS_CONTROL_RESETS) | (1 << TS_CONTROL_EVOW);
+	_tsControl = control[0];
+	control[0] |= (1 << TS_CONTROL_EVR);
+	control[2] &= ~((1 << EVI_CONTROL_EHL) | (0b11 << EVI_CONTROL_ET) | (1 << EVI_CONTROL_ESYN));
+	control[2] |= (debounceTime & 0b11) << EVI_CONTROL_ET; //EHL cleared: falling edge
+	bool returnValue = writeMultipleRegisters(RV3032_TS_CONTROL, control, 3);
+	_tsControlKnown = returnValue;
 
-bool RV3032::clearAllInterruptFlags() //Read the status register to clear the current interrupt flags
-{
-	return writeRegister(RV3032_STATUS, 0b00000000);//Write all 0's to clear all flags
-}
-
-bool RV3032::clearInterruptFlag(uint8_t flagToClear)
-{
-	uint8_t value = readRegister(RV3032_STATUS);
-	value &= ~(1 << flagToClear); //clear flag
-	return writeRegister(RV3032_STATUS, value);
+	uint8_t flags[2] = {(uint8_t)~(1 << STATUS_EVF), (uint8_t)~(1 << TEMP_LSB_BSF)}; //Writing 1 leaves a flag untouched
+	returnValue &= writeMultipleRegisters(RV3032_STATUS, flags, 2);
+	return returnValue;
 }
 
-uint8_t RV3032::BCDtoDEC(uint8_t val)
+/*********************************
+One burst reads the time, STATUS and BSF (0x00-0x0E), a second one the EVI counter and capture. The
+time then goes to the local copy the way updateTime() does it (read again at 59 seconds), so the
+getters don't read it again; if anything fails the copy is left as it was. The start is only known
+when EVI stamped a drop and VLF and PORF are clear: after a power on reset the capture is gone too.
+*********************************/
+bool RV3032::getOutageRecord(RV3032OutageRecord &record)
 {
-	return ( ( val / 0x10) * 10 ) + ( val % 0x10 );
-}
+	uint8_t registers[OUTAGE_READ_LENGTH];
+	uint8_t capture[EVI_CAPTURE_LENGTH];
+	_timeUpdated = false; //Before the read, like updateTime()
+	if (readMultipleRegisters(RV3032_HUNDREDTHS, registers, OUTAGE_READ_LENGTH) == false)
+		return false;
+	if (readMultipleRegisters(RV3032_EVI_COUNT, capture, EVI_CAPTURE_LENGTH) == false)
+		return false;
+	if (commitTime(registers) == false)
+		return false;
 
-// BCDtoDEC -- convert decimal to binary-coded decimal (BCD)
-uint8_t RV3032::DECtoBCD(uint8_t val)
-{
-	return ( ( val / 10 ) * 0x10 ) + ( val % 10 );
+	uint8_t status = registers[RV3032_STATUS];
+	record.status = status;
+	record.switchedOver = (registers[RV3032_TEMP_LSB] >> TEMP_LSB_BSF) & 1;
+	record.timeTrusted = (status & ((1 << STATUS_PORF) | (1 << STATUS_VLF))) == 0;
+	record.drops = capture[0];
+	record.outage = record.switchedOver || record.drops > 0;
+	record.now = rv3032TimeToEpoch(registers);
+
+	//Without a drop the capture holds whatever was there, often all zero
+	record.start = 0;
+	uint8_t month = BCDtoDEC(capture[6] & 0x1F);
+	if (record.drops > 0 && month >= 1 && month <= 12)
+	{
+		//The capture has no weekday, line it up with a time image
+		uint8_t start[TIME_ARRAY_LENGTH] = {capture[1], capture[2], capture[3], capture[4], 0, capture[5], capture[6], capture[7]};
+		record.start = rv3032TimeToEpoch(start);
+	}
+	record.startKnown = record.start != 0 && record.timeTrusted && record.start <= record.now;
+	record.duration = record.startKnown ? record.now - record.start : 0;
+	return true;
 }
 
-bool RV3032::readBit(uint8_t regAddr, uint8_t bitAddr)
+//STATUS and BSF go in one burst, then EVR. EVOW and the EVI settings are kept
+bool RV3032::clearOutageRecord()
 {
-	return ((readRegister(regAddr) & (1 << bitAddr)) >> bitAddr);
+	uint8_t flags[2] = {(uint8_t)~(1 << STATUS_EVF), (uint8_t)~(1 << TEMP_LSB_BSF)};
+	bool returnValue = writeMultipleRegisters(RV3032_STATUS, flags, 2);
+	returnValue &= resetEVICapture();
+	return returnValue;
 }
+#endif
 
-uint8_t RV3032::readTwoBits(uint8_t regAddr, uint8_t bitAddr)
-{
-	return ((readRegister(regAddr) & (3 << bitAddr)) >> bitAddr);
-}
+//****************************************************************************//
+//
+//  EVI event buffer
+//
+//****************************************************************************//
 
-bool RV3032::writeBit(uint8_t regAddr, uint8_t bitAddr, bool bitToWrite)
+#if RV3032_ENABLE_EVI
+RV3032EventBuffer::RV3032EventBuffer( void )
 {
-	uint8_t value = readRegister(regAddr);
-	value &= ~(1 << bitAddr);
-	value |= bitToWrite << bitAddr;
-	return writeRegister(regAddr, value);
-}
 
-bool RV3032::writeBit(uint8_t regAddr, uint8_t bitAddr, uint8_t bitToWrite) //If we see an unsigned 8-bit, we know we have to write two bits.
-{
-	uint8_t value = readRegister(regAddr);
-	value &= ~(3 << bitAddr);
-	value |= bitToWrite << bitAddr;
-	return writeRegister(regAddr, value);
 }
 
-uint8_t RV3032::readRegister(uint8_t addr)
+bool RV3032EventBuffer::push(const RV3032Event &event)
 {
-	_i2cPort->beginTransmission(RV3032_ADDR);
-	_i2cPort->write(addr);
-	_i2cPort->endTransmission();
-
-	//typecasting the 1 parameter in requestFrom so that the compiler
-	//doesn't give us a warning about multiple candidates
-	if (_i2cPort->requestFrom(static_cast<uint8_t>(RV3032_ADDR), static_cast<uint8_t>(1)) != 0)
+	if (_count == RV3032_EVENT_BUFFER_SIZE)
 	{
-		return _i2cPort->read();
+		_dropped++;
+		return false;
 	}
-	return false;
+	_events[(_head + _count) % RV3032_EVENT_BUFFER_SIZE] = event;
+	_count++;
+	return true;
 }
 
-bool RV3032::writeRegister(uint8_t addr, uint8_t val)
+bool RV3032EventBuffer::pop(RV3032Event &event)
 {
-	_i2cPort->beginTransmission(RV3032_ADDR);
-	_i2cPort->write(addr);
-	_i2cPort->write(val);
-	if (_i2cPort->endTransmission() != 0)
-		return (false); //Error: Sensor did not ack
-	return(true);
+	if (_count == 0)
+		return false;
+	event = _events[_head];
+	_head = (_head + 1) % RV3032_EVENT_BUFFER_SIZE;
+	_count--;
+	return true;
 }
 
-bool RV3032::writeMultipleRegisters(uint8_t addr, uint8_t * values, uint8_t len)
+uint8_t RV3032EventBuffer::available()
 {
-	_i2cPort->beginTransmission(RV3032_ADDR);
-	_i2cPort->write(addr);
-	for (uint8_t i = 0; i < len; i++)
-	{
-		_i2cPort->write(values[i]);
-	}
-
-	if (_i2cPort->endTransmission() != 0)
-		return (false); //Error: Sensor did not ack
-	return(true);
+	return _count;
 }
 
-bool RV3032::readMultipleRegisters(uint8_t addr, uint8_t * dest, uint8_t len)
+uint32_t RV3032EventBuffer::getDropped()
 {
-	_i2cPort->beginTransmission(RV3032_ADDR);
-	_i2cPort->write(addr);
-	if (_i2cPort->endTransmission() != 0)
-		return (false); //Error: Sensor did not ack
+	return _dropped;
+}
 
-	_i2cPort->requestFrom(static_cast<uint8_t>(RV3032_ADDR), len);
-	for (uint8_t i = 0; i < len; i++)
-	{
-		dest[i] = _i2cPort->read();
-	}
-	
-	return(true);
+void RV3032EventBuffer::clear()
+{
+	_head = 0;
+	_count = 0;
+	_dropped = 0;
 }
+#endif
@@ -20,25 +20,12 @@ Distributed as-is; no warranty is given.
 
 #pragma once
 
-#if (ARDUINO >= 100)
-#include "Arduino.h"
-#else
-#include "WProgram.h"
-#endif
-
-#include <Wire.h>
+#include "RV_ClockCore.h"
+#include "RV3032_Config.h"
 
 //The 7-bit I2C address of the RV3032
 #define RV3032_ADDR							0x51
 
-#define SUNDAY 0x01
-#define MONDAY 0x02
-#define TUESDAY 0x04
-#define WEDNESDAY 0x08
-#define THURSDAY 0x10
-#define FRIDAY 0x20
-#define SATURDAY 0x40
-
 //Register names:
 #define RV3032_HUNDREDTHS            0x00
 #define RV3032_SECONDS               0x01
@@ -62,37 +49,21 @@ Distributed as-is; no warranty is given.
 #define RV3032_TS_CONTROL            0x13
 #define RV3032_CLOCK_INT_MASK        0x14
 #define RV3032_EVI_CONTROL           0x15
+#define RV3032_EVI_COUNT             0x26 // Number of EVI events since the last EVR reset
 #define RV3032_HUNDREDTHS_CAPTURE    0x27
 #define RV3032_SECONDS_CAPTURE       0x28
 #define RV3032_MINUTES_CAPTURE       0x29
 #define RV3032_HOURS_CAPTURE         0x2A
-//#define RV3032_DAY_CAPTURE         0x2B //Not used, can configure EVI Timestamps to display day, month, and year if desired
-//#define RV3032_MONTH_CAPTURE       0x2C
-//#define RV3032_YEAR_CAPTURE        0x2D
+#define RV3032_DATE_CAPTURE          0x2B
+#define RV3032_MONTH_CAPTURE         0x2C
+#define RV3032_YEAR_CAPTURE          0x2D
+#define RV3032_EEPROM_PMU            0xC0
 #define RV3032_EEPROM_OFFSET         0xC1
 //#define RV3032_EEPROM_CLKOUT_1     0xC2 //Used for HF mode CLKOUT readings, default is XTAL mode
 #define RV3032_EEPROM_CLKOUT_2       0xC3
+//0xC4 and 0xC5 hold the factory temperature reference and are never written by this library
 
 
-//Enable Bits for Alarm Registers
-#define ALARM_ENABLE						7
-
-////Extension Register Bits
-//#define EXTENSION_TEST				7
-//#define EXTENSION_WADA				6
-//#define EXTENSION_USEL				5
-//#define EXTENSION_TE					4
-//#define EXTENSION_FD					2
-//#define EXTENSION_TD					0
-
-////Flag Register Bits
-//#define FLAG_UPDATE						5
-//#define FLAG_TIMER						4
-//#define FLAG_ALARM					  3
-//#define FLAG_EVI							2
-//#define FLAG_V2F							1
-//#define FLAG_V1F							0
-
 //Status Register Bits (1 is triggered, remember to reset!)
 #define STATUS_THF              7 // Temp. High Flag
 #define STATUS_TLF              6 // Temp Low Flag
@@ -103,6 +74,12 @@ Distributed as-is; no warranty is given.
 #define STATUS_PORF             1 // Power On Reset Flag
 #define STATUS_VLF              0 // Voltage Low Flag
 
+//Temperature LSB Register Bits
+#define TEMP_LSB_EEF            3 // EEPROM Write Fail Flag
+#define TEMP_LSB_EEBUSY         2 // EEPROM Memory Busy Status Bit
+#define TEMP_LSB_CLKF           1 // Clock Output Interrupt Flag
+#define TEMP_LSB_BSF            0 // Backup Switchover Flag
+
 //Control 1 Register Bits
 #define CONTROL1_USEL           4 // Update Interrupt Select
 #define CONTROL1_TE             3 // Periodic Countdown Timer Enable
@@ -125,13 +102,24 @@ Distributed as-is; no warranty is given.
 #define CONTROL3_TLIE           0 // Temperature Low Interrupt Enable
 
 //TS Control Register Bits
-#define TS_CONTROL_EVR          7 // Time Stamp EVI Reset
+#define TS_CONTROL_EVR          5 // Time Stamp EVI Reset (self clearing)
+#define TS_CONTROL_THR          4 // Time Stamp Temp. High Reset (self clearing)
+#define TS_CONTROL_TLR          3 // Time Stamp Temp. Low Reset (self clearing)
 #define TS_CONTROL_EVOW         2 // Time Stamp EVI Overwrite
+#define TS_CONTROL_THOW         1 // Time Stamp Temp. High Overwrite
+#define TS_CONTROL_TLOW         0 // Time Stamp Temp. Low Overwrite
+#define TS_CONTROL_RESETS       ((1 << TS_CONTROL_EVR) | (1 << TS_CONTROL_THR) | (1 << TS_CONTROL_TLR))
 
 //EVI Control Register Bits
 #define EVI_CONTROL_EHL         6 // Event High/Low Level (Rising/Falling Edge) selection
 #define EVI_CONTROL_ET          4 // Event Filtering Time set
-#define EVI_CONTROL_ESYN        0 // Event Filtering Time set
+#define EVI_CONTROL_ESYN        0 // Time synchronization with EVI
+
+//EEPROM PMU Register Bits
+#define EEPROM_PMU_NCLKE        6 // CLKOUT disable (1 turns the output off)
+#define EEPROM_PMU_BSM          4 // Backup Switchover Mode
+#define EEPROM_PMU_TCR          2 // Trickle Charger Series Resistance
+#define EEPROM_PMU_TCM          0 // Trickle Charger Mode
 
 //EEPROM CLKOUT Register Bits
 #define EEPROM_CLKOUT2_OS       7 // Oscillator Selection
@@ -139,158 +127,164 @@ Distributed as-is; no warranty is given.
 
 
 //Possible Settings
-#define TWELVE_HOUR_MODE					         true
-#define TWENTYFOUR_HOUR_MODE				       false
-#define COUNTDOWN_TIMER_FREQUENCY_4096_HZ	 0b00
-#define COUNTDOWN_TIMER_FREQUENCY_64_HZ		 0b01
-#define COUNTDOWN_TIMER_FREQUENCY_1_HZ		 0b10
-#define COUNTDOWN_TIMER_FREQUENCY_1/60_HZ	 0b11
 #define CLKOUT_FREQUENCY_32768_HZ	      	 0b00
 #define CLKOUT_FREQUENCY_1024_HZ		     	 0b01
 #define CLKOUT_FREQUENCY_64_HZ		      	 0b10
 #define CLKOUT_FREQUENCY_1_HZ              0b11
 
-#define COUNTDOWN_TIMER_ON				       	 true
-#define COUNTDOWN_TIMER_OFF					       false
-#define TIME_UPDATE_1_SECOND				       false
-#define TIME_UPDATE_1_MINUTE				       true
-
-#define ENABLE_EVI_CALIBRATION				     true
-#define DISABLE_EVI_CALIBRATION				     false
-#define EVI_DEBOUNCE_NONE					         0b00 // 0ms, default
-#define EVI_DEBOUNCE_256HZ					       0b01 // 256Hz ~= 3.9ms
-#define EVI_DEBOUNCE_64HZ					         0b10 // 64Hz ~= 15.6ms
-#define EVI_DEBOUNCE_8HZ					         0b11 // 8Hz ~= 125ms
-#define RISING_EDGE							           true
-#define FALLING_EDGE						           false
-#define EVI_CAPTURE_ENABLE			        	 true
-#define EVI_CAPTURE_DISABLE					       false
-
-#define ENABLE								             true
-#define DISABLE								             false
-
-#define TIME_ARRAY_LENGTH                  8 // Total number of writable values in device
-
-enum time_order {
-	TIME_HUNDREDTHS,	// 0
-	TIME_SECONDS,		// 1
-	TIME_MINUTES,		// 2
-	TIME_HOURS,			// 3
-	TIME_WEEKDAY,		// 4
-	TIME_DATE,			// 5
-	TIME_MONTH,			// 6
-	TIME_YEAR,			// 7
+#define EVI_CAPTURE_FIRST_EVENT            false // Keep the timestamp of the first event after a reset
+#define EVI_CAPTURE_LAST_EVENT             true  // Overwrite the timestamp with every new event
+
+#define SYNC_EDGE_TIMEOUT_MS               1100 // Longest wait for a PPS edge in syncToEdge()
+#define EVI_CAPTURE_LENGTH                 8 // Event counter followed by the 7 capture registers
+#define OUTAGE_READ_LENGTH                 15 // Time to temperature LSB 0x00-0x0E: time, STATUS and BSF in one burst
+
+#define CONFIG_CONTROL_LENGTH              14 // Alarm, timer, status and control registers 0x08-0x15
+#define CONFIG_EEPROM_LENGTH               4  // EEPROM mirror 0xC0-0xC3 (PMU, offset, CLKOUT)
+
+#ifndef RV3032_EVENT_BUFFER_SIZE
+#define RV3032_EVENT_BUFFER_SIZE           16 // Number of decoded events held by RV3032EventBuffer
+#endif
+
+//A single drained EVI capture. Values are decimal, year is 0-99 (2000-2099)
+struct RV3032Event
+{
+	uint8_t hundredths;
+	uint8_t seconds;
+	uint8_t minutes;
+	uint8_t hours;
+	uint8_t date;
+	uint8_t month;
+	uint8_t year;
+	uint8_t count; //Events the RTC counted since the previous drain, the timestamp belongs to the first or last of them
+};
+
+//What RV3032::getOutageRecord() found at boot. Times are UNIX epoch seconds as the RTC counts them
+struct RV3032OutageRecord
+{
+	bool outage; //BSF is set or EVI saw the supply drop since clearOutageRecord()
+	bool switchedOver; //BSF: the RTC ran from VBACKUP
+	bool timeTrusted; //Neither VLF nor PORF: the clock kept good time through the outage
+	bool startKnown; //EVI stamped the drop and the time can be trusted, start and duration are valid
+	uint8_t drops; //Supply drops EVI counted, start belongs to the last one
+	uint8_t status; //STATUS as read, for the other flags
+	uint32_t start; //When the supply dropped, 0 without a valid stamp
+	uint32_t now; //When the record was read
+	uint32_t duration; //now - start in seconds, 0 unless startKnown
+};
+
+#if RV3032_ENABLE_EVI
+//Fixed size ring buffer filled by RV3032::drainEVIEvents()
+class RV3032EventBuffer
+{
+public:
+
+	RV3032EventBuffer( void );
+
+	bool push(const RV3032Event &event); //Returns false and counts a drop when the buffer is full
+	bool pop(RV3032Event &event); //Returns false when the buffer is empty
+	uint8_t available();
+	uint32_t getDropped(); //Captures discarded because the buffer was full
+	void clear();
+
+  private:
+	RV3032Event _events[RV3032_EVENT_BUFFER_SIZE];
+	uint8_t _head = 0;
+	uint8_t _count = 0;
+	uint32_t _dropped = 0;
+};
+#endif
+
+//Everything needed to bring a reset RTC back to a known configuration, see RV3032::saveConfig()
+struct RV3032ConfigImage
+{
+	uint8_t control[CONFIG_CONTROL_LENGTH]; //Registers 0x08-0x15, status and temperature are stored but never restored
+	uint8_t eeprom[CONFIG_EEPROM_LENGTH]; //Registers 0xC0-0xC3
+	uint8_t crc; //CRC-8 over control and eeprom
+};
+
+//Register layout of the RV-3032 for RVClockCore
+struct RV3032Traits
+{
+	static const uint8_t ADDRESS = RV3032_ADDR;
+	static const uint8_t TIME_REG = RV3032_HUNDREDTHS;
+	static const bool WEEKDAY_ONE_HOT = false;
+	static const uint8_t ALARM_REG = RV3032_MINUTES_ALARM;
+	static const bool WEEKDAY_ALARM = false;
+	static const uint8_t ALARM_SELECT_REG = 0;
+	static const uint8_t ALARM_SELECT_BIT = 0;
+	static const uint8_t TIMER_REG = RV3032_TIMER_0;
+	static const uint8_t TIMER_CONTROL_REG = RV3032_CONTROL1;
+	static const uint8_t TIMER_ENABLE_BIT = CONTROL1_TE;
+	static const uint8_t TIMER_FREQUENCY_BIT = CONTROL1_TD;
+	static const uint8_t UPDATE_SELECT_BIT = CONTROL1_USEL;
+	static const uint8_t INTERRUPT_REG = RV3032_CONTROL2;
+	static const uint8_t HOLD_BIT = CONTROL2_STOP;
+	static const uint8_t FLAG_REG = RV3032_STATUS;
+	static const uint8_t EVI_CONTROL_REG = RV3032_EVI_CONTROL;
+	static const uint8_t EVI_EDGE_BIT = EVI_CONTROL_EHL;
+	static const uint8_t EVI_FILTER_BIT = EVI_CONTROL_ET;
+	static const uint8_t EVI_SYNC_BIT = EVI_CONTROL_ESYN;
+	static const uint8_t CAPTURE_REG = RV3032_HUNDREDTHS_CAPTURE;
+	static const uint8_t CAPTURE_FIELDS = 7; //Hundredths to year
+	static const uint8_t OFFSET_REG = RV3032_EEPROM_OFFSET;
+	static const uint16_t OFFSET_STEP_TENTH_PPB = 2384;
+	static const uint8_t CLKOUT_REG = RV3032_EEPROM_CLKOUT_2;
+	static const uint8_t CLKOUT_BIT = EEPROM_CLKOUT2_FD;
 };
 
-class RV3032
+class RV3032 : public RVClockCore<RV3032Traits>
 {
 public:
 	
 	RV3032( void );
 
 	bool begin(TwoWire &wirePort = Wire);
-	
-	void set12Hour();
-	void set24Hour();
-	bool is12Hour(); //Returns true if 12hour bit is set
-	bool isPM(); //Returns true if is12Hour and PM bit is set
-
-	char* stringDateUSA(); //Return date in mm-dd-yyyy
-	char* stringDate(); //Return date in dd-mm-yyyy
-	char* stringTime(); //Return time hh:mm:ss with AM/PM if in 12 hour mode
-	char* stringTimestamp(); //Return timestamp in hh:mm:ss:hh, note that this must be read the same minute that the timestamp occurs or the minute will be wrong
-	char* stringTime8601(); //Return time in ISO 8601 format yyyy-mm-ddThh:mm:ss
-		
-	bool setTime(uint8_t sec, uint8_t min, uint8_t hour, uint8_t weekday, uint8_t date, uint8_t month, uint16_t year);
-	bool setTime(uint8_t * time, uint8_t len);
-	bool setEpoch(uint32_t value);
-	bool setHundredthsToZero();
-	bool setSeconds(uint8_t value);
-	bool setMinutes(uint8_t value);
-	bool setHours(uint8_t value);
-	bool setDate(uint8_t value);
-	bool setWeekday(uint8_t value);
-	bool setMonth(uint8_t value);
-	bool setYear(uint16_t value);
-
-	bool updateTime(); //Update the local array with the RTC registers
-
-	uint8_t getHundredths();
-	uint8_t getSeconds();
-	uint8_t getMinutes();
-	uint8_t getHours();
-	uint8_t getDate();
-	uint8_t getWeekday();
-	uint8_t getMonth();
-	uint16_t getYear();	
-	uint32_t getEpoch();
-	
-	uint8_t getHundredthsCapture();
-	uint8_t getSecondsCapture();
-  uint8_t getMinutesCapture();
-	
-	bool setToCompilerTime(); //Uses the hours, mins, etc from compile time to set RTC
-	
-	bool setCalibrationOffset(float ppm);
-	float getCalibrationOffset();
-	
-	bool setEVICalibration(bool eviCalibration);
-	bool setEVIDebounceTime(uint8_t debounceTime);
-	bool setEVIEdgeDetection(bool edge);
-	bool setEVIEventCapture(bool capture);
-  bool setTSOverwrite(bool overwrite);
-	
-	bool getEVICalibration();
-	uint8_t getEVIDebounceTime();
-	bool getEVIEdgeDetection();
-	
-	
-	bool setCountdownTimerEnable(bool timerState); //Starts and stops our countdown timer
-	bool setCountdownTimerClockTicks(uint16_t clockTicks);
-	bool setCountdownTimerFrequency(uint8_t countdownTimerFrequency);
-	
-	bool setClockOutTimerFrequency(uint8_t clockOutTimerFrequency);
-	uint8_t getClockOutTimerFrequency();
-		
-	bool getCountdownTimerEnable();
-	uint16_t getCountdownTimerClockTicks();
-	uint8_t getCountdownTimerFrequency();
-	
-	bool setPeriodicTimeUpdateFrequency(bool timeUpdateFrequency);
-	bool getPeriodicTimeUpdateFrequency();
-	
-	void setItemsToMatchForAlarm(bool minuteAlarm, bool hourAlarm, bool dateAlarm); //0 to 7, alarm goes off with match of second, minute, hour, etc
-	bool setAlarmMinutes(uint8_t minute);
-	bool setAlarmHours(uint8_t hour);
-	bool setAlarmDate(uint8_t date);
-	
-	uint8_t getAlarmMinutes();
-	uint8_t getAlarmHours();
-	uint8_t getAlarmDate();
+	bool begin(const RV3032ConfigImage &image, TwoWire &wirePort = Wire); //Restores image if the RTC reports PORF or VLF
+	bool begin(const RV3032Config &config, TwoWire &wirePort = Wire); //Applies a compile time configuration in one burst, false without a bus write if config.isValid() is false
 
-	bool enableHardwareInterrupt(uint8_t source); //Enables a given interrupt within Interrupt Enable register
-	bool disableHardwareInterrupt(uint8_t source); //Disables a given interrupt within Interrupt Enable register
-	bool disableAllInterrupts();
-	
-	bool getInterruptFlag(uint8_t flagToGet);
-	bool clearInterruptFlag(uint8_t flagToClear);
-	bool clearAllInterruptFlags();
-		
-	//Values in RTC are stored in Binary Coded Decimal. These functions convert to/from Decimal
-	uint8_t BCDtoDEC(uint8_t val); 
-	uint8_t DECtoBCD(uint8_t val);
-
-	bool readBit(uint8_t regAddr, uint8_t bitAddr);
-	uint8_t readTwoBits(uint8_t regAddr, uint8_t bitAddr);
-	bool writeBit(uint8_t regAddr, uint8_t bitAddr, bool bitToWrite);
-	bool writeBit(uint8_t regAddr, uint8_t bitAddr, uint8_t bitToWrite);
-	uint8_t readRegister(uint8_t addr);
-	bool writeRegister(uint8_t addr, uint8_t val);
-	bool readMultipleRegisters(uint8_t addr, uint8_t * dest, uint8_t len);
-	bool writeMultipleRegisters(uint8_t addr, uint8_t * values, uint8_t len);
+	bool saveConfig(RV3032ConfigImage &image); //Two burst reads
+	bool restoreConfig(const RV3032ConfigImage &image); //Three burst writes, false if the CRC doesn't match
+
+#if RV3032_ENABLE_EPOCH
+	bool syncTo(uint64_t epochMs, int32_t *offsetUs = NULL); //epochMs is the reference time at the moment of the call
+	bool syncToEdge(uint32_t epochAtEdge, uint8_t ppsPin, bool edge = RISING_EDGE, int32_t *offsetUs = NULL); //Starts the clock on the next PPS edge
+#endif
+
+#if RV3032_ENABLE_EEPROM
+	bool enableClockOut(uint8_t frequency); //Sets the frequency and clears NCLKE
+	bool disableClockOut();
+	bool setClockOutInterruptControlled(bool enable, uint8_t interruptMask = 0); //Sets CLKIE and NCLKE: CLKOUT only runs while an interrupt in the 0x14 mask is pending. Disabling leaves it running
+
+	bool setPowerProfile(const RV3032PowerProfile &profile); //Two reads, then two writes only if both reads worked
+	uint8_t getBackupSwitchoverMode();
+	bool getBackupSwitchoverFlag(); //BSF, set when the RTC ran from VBACKUP
+	bool clearBackupSwitchoverFlag();
+#endif
+
+#if RV3032_ENABLE_EVI
+	uint8_t getMinutesCapture();
+
+	bool setEVIEventCapture(bool capture);
+	bool setTSOverwrite(bool overwrite); //EVI_CAPTURE_FIRST_EVENT or EVI_CAPTURE_LAST_EVENT
+	bool resetEVICapture(); //Clears the event counter and capture registers
+	uint8_t drainEVIEvents(RV3032EventBuffer &buffer); //Returns the number of events counted since the last drain
+	uint32_t getEVIEventTotal(); //Events counted by all drains since begin()
+
+	//Outage record: the main supply goes to EVI too, so the capture stamps the moment it drops
+	bool enableOutageCapture(uint8_t debounceTime = EVI_DEBOUNCE_256HZ); //Falling edge, last drop kept, no ESYN. One read, two writes
+	bool getOutageRecord(RV3032OutageRecord &record); //Two burst reads (three at 59 seconds), also updates the time like updateTime()
+	bool clearOutageRecord(); //Clears BSF, EVF and the capture. PORF and VLF stay until the time is set
+#endif
 
   private:
-	uint8_t _time[TIME_ARRAY_LENGTH];
-	bool _isTwelveHour = true;
-	TwoWire *_i2cPort;
+#if RV3032_ENABLE_EVI
+	bool loadTSControl(); //Reads TS control unless the copy is known
+#endif
+
+	uint32_t _eviEventTotal = 0;
+	uint8_t _tsControl = 0; //TS control without the reset bits, as last read or written by drainEVIEvents() and friends
+	bool _tsControlKnown = false; //Cleared by everything else that writes TS control
 };
+
+typedef RVTimeHold<RV3032> RV3032TimeHold; //Getters in its scope share one reading, see holdTime()
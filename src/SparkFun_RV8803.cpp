@@ -0,0 +1,58 @@
+/******************************************************************************
+SparkFun_RV8803.cpp
+RV3032 Arduino Library
+
+RV-8803-C7 specific functions, the shared ones live in RV_ClockCore.cpp
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example. If you have any questions
+or concerns with licensing, please contact techsupport@sparkfun.com.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#include "SparkFun_RV8803.h"
+
+RV8803::RV8803( void )
+{
+
+}
+
+#if RV3032_ENABLE_INTERRUPTS
+//The third alarm register holds either a weekday mask or a date, picked by WADA
+void RV8803::setItemsToMatchForAlarm(bool minuteAlarm, bool hourAlarm, bool weekdayAlarm, bool dateAlarm)
+{
+	if (weekdayAlarm == true || dateAlarm == true)
+	{
+		writeBit(RV8803_EXTENSION, EXTENSION_WADA, dateAlarm);
+	}
+	setItemsToMatchForAlarm(minuteAlarm, hourAlarm, weekdayAlarm || dateAlarm);
+}
+
+bool RV8803::setAlarmWeekday(uint8_t weekday)
+{
+	bool returnValue = writeBit(RV8803_EXTENSION, EXTENSION_WADA, false);
+	uint8_t value = readRegister(RV8803_WEEKDAYS_DATE_ALARM);
+	value &= (1 << ALARM_ENABLE); //clear everything but enable bit
+	value |= weekday & 0x7F;
+	returnValue &= writeRegister(RV8803_WEEKDAYS_DATE_ALARM, value);
+	return returnValue;
+}
+
+uint8_t RV8803::getAlarmWeekday()
+{
+	return readRegister(RV8803_WEEKDAYS_DATE_ALARM) & 0x7F;
+}
+#endif
+
+#if RV3032_ENABLE_EVI
+//Unlike the RV-3032, the RV-8803 only timestamps events while ECP is set
+bool RV8803::setEVIEventCapture(bool capture)
+{
+	return writeBit(RV8803_EVENT_CONTROL, EVENT_ECP, capture);
+}
+
+bool RV8803::getEVIEventCapture()
+{
+	return readBit(RV8803_EVENT_CONTROL, EVENT_ECP);
+}
+#endif
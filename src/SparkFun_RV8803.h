@@ -0,0 +1,119 @@
+/******************************************************************************
+SparkFun_RV8803.h
+RV3032 Arduino Library
+
+RV-8803-C7 driver on the shared RVClockCore. The time, alarm, timer, interrupt,
+calibration and EVI functions are the same code as the RV3032 class; only the
+register map below and the few functions the RV-8803 does differently live here.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example. If you have any questions
+or concerns with licensing, please contact techsupport@sparkfun.com.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#pragma once
+
+#include "RV_ClockCore.h"
+
+//The 7-bit I2C address of the RV8803
+#define RV8803_ADDR                  0x32
+
+//Register names (the 0x10 bank, which starts with the hundredths):
+#define RV8803_HUNDREDTHS            0x10
+#define RV8803_SECONDS               0x11
+#define RV8803_MINUTES               0x12
+#define RV8803_HOURS                 0x13
+#define RV8803_WEEKDAYS              0x14
+#define RV8803_DATE                  0x15
+#define RV8803_MONTHS                0x16
+#define RV8803_YEARS                 0x17
+#define RV8803_MINUTES_ALARM         0x18
+#define RV8803_HOURS_ALARM           0x19
+#define RV8803_WEEKDAYS_DATE_ALARM   0x1A
+#define RV8803_TIMER_0               0x1B
+#define RV8803_TIMER_1               0x1C
+#define RV8803_EXTENSION             0x1D
+#define RV8803_FLAG                  0x1E
+#define RV8803_CONTROL               0x1F
+#define RV8803_HUNDREDTHS_CAPTURE    0x20
+#define RV8803_SECONDS_CAPTURE       0x21
+#define RV8803_OFFSET                0x2C
+#define RV8803_EVENT_CONTROL         0x2F
+
+//Extension Register Bits
+#define EXTENSION_TEST          7
+#define EXTENSION_WADA          6 // Weekday (0) or date (1) alarm
+#define EXTENSION_USEL          5 // Update Interrupt Select
+#define EXTENSION_TE            4 // Periodic Countdown Timer Enable
+#define EXTENSION_FD            2 // CLKOUT Frequency Selection
+#define EXTENSION_TD            0 // Timer Clock Frequency selection
+
+//Flag Register Bits, see FLAG_UPDATE to FLAG_EVI for the others
+#define FLAG_V2F                1 // Voltage Low Flag 2, data no longer valid
+#define FLAG_V1F                0 // Voltage Low Flag 1, temperature compensation stopped
+
+//Control Register Bits
+#define CONTROL_RESET           0 // Prescaler reset
+
+//Event Control Register Bits
+#define EVENT_ECP               7 // Event Capture enable
+#define EVENT_EHL               6 // Event High/Low Level (Rising/Falling Edge) selection
+#define EVENT_ET                4 // Event Filtering Time set
+#define EVENT_ERST              0 // Reset the hundredths on an event
+
+//Possible Settings
+#define CLOCK_OUT_FREQUENCY_32768_HZ       0b00
+#define CLOCK_OUT_FREQUENCY_1024_HZ        0b01
+#define CLOCK_OUT_FREQUENCY_1_HZ           0b10
+
+//Register layout of the RV-8803 for RVClockCore
+struct RV8803Traits
+{
+	static const uint8_t ADDRESS = RV8803_ADDR;
+	static const uint8_t TIME_REG = RV8803_HUNDREDTHS;
+	static const bool WEEKDAY_ONE_HOT = true;
+	static const uint8_t ALARM_REG = RV8803_MINUTES_ALARM;
+	static const bool WEEKDAY_ALARM = true;
+	static const uint8_t ALARM_SELECT_REG = RV8803_EXTENSION;
+	static const uint8_t ALARM_SELECT_BIT = EXTENSION_WADA;
+	static const uint8_t TIMER_REG = RV8803_TIMER_0;
+	static const uint8_t TIMER_CONTROL_REG = RV8803_EXTENSION;
+	static const uint8_t TIMER_ENABLE_BIT = EXTENSION_TE;
+	static const uint8_t TIMER_FREQUENCY_BIT = EXTENSION_TD;
+	static const uint8_t UPDATE_SELECT_BIT = EXTENSION_USEL;
+	static const uint8_t INTERRUPT_REG = RV8803_CONTROL;
+	static const uint8_t HOLD_BIT = CONTROL_RESET;
+	static const uint8_t FLAG_REG = RV8803_FLAG;
+	static const uint8_t EVI_CONTROL_REG = RV8803_EVENT_CONTROL;
+	static const uint8_t EVI_EDGE_BIT = EVENT_EHL;
+	static const uint8_t EVI_FILTER_BIT = EVENT_ET;
+	static const uint8_t EVI_SYNC_BIT = EVENT_ERST;
+	static const uint8_t CAPTURE_REG = RV8803_HUNDREDTHS_CAPTURE;
+	static const uint8_t CAPTURE_FIELDS = 2; //Hundredths and seconds only
+	static const uint8_t OFFSET_REG = RV8803_OFFSET;
+	static const uint16_t OFFSET_STEP_TENTH_PPB = 2384;
+	static const uint8_t CLKOUT_REG = RV8803_EXTENSION;
+	static const uint8_t CLKOUT_BIT = EXTENSION_FD;
+};
+
+class RV8803 : public RVClockCore<RV8803Traits>
+{
+public:
+
+	RV8803( void );
+
+#if RV3032_ENABLE_INTERRUPTS
+	using RVClockCore<RV8803Traits>::setItemsToMatchForAlarm;
+	void setItemsToMatchForAlarm(bool minuteAlarm, bool hourAlarm, bool weekdayAlarm, bool dateAlarm); //Date wins if both weekday and date are set
+	bool setAlarmWeekday(uint8_t weekday); //SUNDAY | SATURDAY etc, selects the weekday alarm
+	uint8_t getAlarmWeekday();
+#endif
+
+#if RV3032_ENABLE_EVI
+	bool setEVIEventCapture(bool capture);
+	bool getEVIEventCapture();
+#endif
+};
+
+typedef RVTimeHold<RV8803> RV8803TimeHold; //Getters in its scope share one reading, see holdTime()